@@ -0,0 +1,124 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+    @brief Lock-free atomic operations on 32 and 64 bit integers.  Loads have acquire
+      semantics, stores have release semantics and read-modify-write operations are
+      sequentially consistent
+*/
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+/* @brief Atomically reads the value */
+FZY_INLINE u64 atomic_u64_load( volatile u64* ptr )
+{
+  u64 value = *ptr;
+  _ReadWriteBarrier();
+  return value;
+}
+
+/* @brief Atomically writes the value */
+FZY_INLINE void atomic_u64_store( volatile u64* ptr, u64 value )
+{
+  _ReadWriteBarrier();
+  *ptr = value;
+}
+
+/* @brief Atomically adds to the value, returns the value before the add */
+FZY_INLINE u64 atomic_u64_add( volatile u64* ptr, u64 value )
+{
+  return (u64)_InterlockedExchangeAdd64( (volatile long long*)ptr, (long long)value );
+}
+
+/* @brief Atomically subtracts from the value, returns the value before the subtract */
+FZY_INLINE u64 atomic_u64_sub( volatile u64* ptr, u64 value )
+{
+  return (u64)_InterlockedExchangeAdd64( (volatile long long*)ptr, -(long long)value );
+}
+
+/* @brief Writes desired if the value equals expected, otherwise loads the value into expected */
+FZY_INLINE b8 atomic_u64_compare_exchange( volatile u64* ptr, u64* expected, u64 desired )
+{
+  u64 previous = (u64)_InterlockedCompareExchange64( (volatile long long*)ptr, (long long)desired, (long long)*expected );
+  if( previous == *expected ) return true;
+  *expected = previous;
+  return false;
+}
+
+/* @brief Atomically reads the value */
+FZY_INLINE u32 atomic_u32_load( volatile u32* ptr )
+{
+  u32 value = *ptr;
+  _ReadWriteBarrier();
+  return value;
+}
+
+/* @brief Atomically writes the value */
+FZY_INLINE void atomic_u32_store( volatile u32* ptr, u32 value )
+{
+  _ReadWriteBarrier();
+  *ptr = value;
+}
+
+/* @brief Writes desired if the value equals expected, otherwise loads the value into expected */
+FZY_INLINE b8 atomic_u32_compare_exchange( volatile u32* ptr, u32* expected, u32 desired )
+{
+  u32 previous = (u32)_InterlockedCompareExchange( (volatile long*)ptr, (long)desired, (long)*expected );
+  if( previous == *expected ) return true;
+  *expected = previous;
+  return false;
+}
+
+#else
+
+/* @brief Atomically reads the value */
+FZY_INLINE u64 atomic_u64_load( volatile u64* ptr )
+{
+  return __atomic_load_n( ptr, __ATOMIC_ACQUIRE );
+}
+
+/* @brief Atomically writes the value */
+FZY_INLINE void atomic_u64_store( volatile u64* ptr, u64 value )
+{
+  __atomic_store_n( ptr, value, __ATOMIC_RELEASE );
+}
+
+/* @brief Atomically adds to the value, returns the value before the add */
+FZY_INLINE u64 atomic_u64_add( volatile u64* ptr, u64 value )
+{
+  return __atomic_fetch_add( ptr, value, __ATOMIC_SEQ_CST );
+}
+
+/* @brief Atomically subtracts from the value, returns the value before the subtract */
+FZY_INLINE u64 atomic_u64_sub( volatile u64* ptr, u64 value )
+{
+  return __atomic_fetch_sub( ptr, value, __ATOMIC_SEQ_CST );
+}
+
+/* @brief Writes desired if the value equals expected, otherwise loads the value into expected */
+FZY_INLINE b8 atomic_u64_compare_exchange( volatile u64* ptr, u64* expected, u64 desired )
+{
+  return __atomic_compare_exchange_n( ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+}
+
+/* @brief Atomically reads the value */
+FZY_INLINE u32 atomic_u32_load( volatile u32* ptr )
+{
+  return __atomic_load_n( ptr, __ATOMIC_ACQUIRE );
+}
+
+/* @brief Atomically writes the value */
+FZY_INLINE void atomic_u32_store( volatile u32* ptr, u32 value )
+{
+  __atomic_store_n( ptr, value, __ATOMIC_RELEASE );
+}
+
+/* @brief Writes desired if the value equals expected, otherwise loads the value into expected */
+FZY_INLINE b8 atomic_u32_compare_exchange( volatile u32* ptr, u32* expected, u32 desired )
+{
+  return __atomic_compare_exchange_n( ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+}
+
+#endif
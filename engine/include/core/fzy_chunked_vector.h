@@ -0,0 +1,107 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief A vector stored in fixed-size chunks.  Growing adds a chunk and never moves the elements,
+    so pointers returned by push and get stay valid until the element is removed.  Indexing is a
+    shift and a mask, use it for storage that hands out long-lived pointers
+*/
+typedef struct chunked_vector chunked_vector;
+
+/*
+  @brief Creates a new chunked vector with the appropiate memory tag, Use chunked_vector_create instead
+
+  @param element_size The size of each element in the vector
+  @param elements_per_chunk The number of elements in each chunk, rounded up to a power of two
+  @param memory_tag The memory tag for the chunks
+  @param file The source file creating the vector, supplied by the chunked_vector_create macro
+  @param line The source line creating the vector, supplied by the chunked_vector_create macro
+  @return Pointer - Points to the created vector
+*/
+FZY_API chunked_vector *_chunked_vector_create( u64 element_size, u32 elements_per_chunk, u16 memory_tag, const char *file, u32 line );
+
+/*
+  @brief Creates a new chunked vector whose chunks come from the given allocator, Use
+    chunked_vector_create_with_allocator instead
+
+  @param element_size The size of each element in the vector
+  @param elements_per_chunk The number of elements in each chunk, rounded up to a power of two
+  @param allocator The allocator for the vector's memory, copied into the vector
+  @param file The source file creating the vector, supplied by the chunked_vector_create_with_allocator macro
+  @param line The source line creating the vector, supplied by the chunked_vector_create_with_allocator macro
+  @return Pointer - Points to the created vector or 0 if the allocator failed
+*/
+FZY_API chunked_vector *_chunked_vector_create_with_allocator( u64 element_size, u32 elements_per_chunk, const memory_allocator* allocator,
+                                                               const char *file, u32 line );
+
+/*
+  @brief Frees all memory held by the vector
+
+  @param vector The vector to release
+*/
+FZY_API void chunked_vector_destroy( chunked_vector *vector );
+
+/*
+  @brief Push a copy of element onto the back of the vector
+
+  @param vector Vector to access
+  @param element Pointer to the element to add ( memcpy ), 0 to add a zeroed element
+  @return Ptr - Points to the element in the vector, stays valid until it is removed
+*/
+FZY_API void *chunked_vector_push( chunked_vector *vector, const void *element );
+
+/*
+  @brief Removes the last element in the vector
+
+  @param vector The vector to access
+*/
+FZY_API void chunked_vector_pop( chunked_vector *vector );
+
+/*
+  @brief Remove the element at the given index by copying the last element into its slot.  The
+    last element changes address, every other element keeps its address
+
+  @param vector The vector to access
+  @param index The index to remove the element from
+*/
+FZY_API void chunked_vector_remove_index_swap( chunked_vector *vector, u32 index );
+
+/*
+  @brief Returns the element at the given index in the vector
+
+  @param vector - The vector to access
+  @param index - The index to access
+  @return Ptr - Points to the element at the index, or 0 if the index is out of range
+*/
+FZY_API void *_chunked_vector_get( chunked_vector *vector, u32 index );
+
+/*
+  @brief Returns the number of elements in the vector
+
+  @param vector The vector to access
+  @return The number of elements in the vector
+*/
+FZY_API u32 chunked_vector_size( chunked_vector *vector );
+
+/*
+  @brief Gets the number of elements the allocated chunks can hold
+
+  @param vector The vector to access
+  @return The capactity
+*/
+FZY_API u32 chunked_vector_capacity( chunked_vector *vector );
+
+/*
+  @brief Sets the count of the vector to zero, the chunks are kept for reuse
+
+  @param The vector to access
+*/
+FZY_API void chunked_vector_clear( chunked_vector *vector );
+
+// Macros -----------------
+#define chunked_vector_create( element_size, elements_per_chunk, tag ) _chunked_vector_create( element_size, elements_per_chunk, tag, __FILE__, __LINE__ )
+#define chunked_vector_create_with_allocator( element_size, elements_per_chunk, allocator ) \
+  _chunked_vector_create_with_allocator( element_size, elements_per_chunk, allocator, __FILE__, __LINE__ )
+#define chunked_vector_get( type, vector, index ) (type*)_chunked_vector_get( vector, index )
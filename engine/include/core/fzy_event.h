@@ -98,6 +98,21 @@ typedef enum system_event_code
      */
     FZY_EVENT_CODE_SET_RENDER_MODE,
 
+    /** @brief A memory tag crossed its soft budget, sent at the end of the frame usage rose past it.
+     * Context usage:
+     * fzy_memory_tag tag = data.data.u64[0];
+     * u64 bytes_in_use = data.data.u64[1];
+     */
+    FZY_EVENT_CODE_MEMORY_SOFT_BUDGET,
+
+    /** @brief An allocation was refused because it would exceed the tag's hard budget, sent at the
+     * end of the frame, once however many allocations were refused in it.
+     * Context usage:
+     * fzy_memory_tag tag = data.data.u64[0];
+     * u64 bytes_requested = data.data.u64[1];   // the last refused request
+     */
+    FZY_EVENT_CODE_MEMORY_HARD_BUDGET,
+
     /** @brief Special-purpose debugging event. Context will vary over time. */
     FZY_EVENT_CODE_DEBUG0,
     /** @brief Special-purpose debugging event. Context will vary over time. */
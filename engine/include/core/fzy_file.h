@@ -1,6 +1,8 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_string.h"
 
 /**
   @brief Holds a file handle
@@ -10,6 +12,7 @@ typedef struct file_handle
   u8 *data;    // holds the internal file data
   u64 pos;     // holds the position in the file
   u64 size;    // holds the size of the data array
+  memory_stack *stack;   // the stack holding the data, 0 when the data is heap allocated
 
 } file_handle;
 
@@ -22,6 +25,17 @@ typedef struct file_handle
 */
 FZY_API b8 file_read( const char* path, file_handle* out_handle );
 
+/**
+  @brief Read the file at the path into a block on the stack, no heap allocation is made.  The
+    data lives until the stack is freed past it, file_close only clears the handle
+
+  @param path - the full path to the file to read
+  @param stack - the stack to read into, usually memory_scratch_stack
+  @param out_handle - the file handle struct to load into
+  @return b8 - true if successful, false if the file could not be read or does not fit
+*/
+FZY_API b8 file_read_stack( const char* path, memory_stack* stack, file_handle* out_handle );
+
 /**
   @brief Releases the file handle data
 
@@ -39,6 +53,24 @@ FZY_API void file_close( file_handle *handle );
 */
 FZY_API b8 file_read_bytes( file_handle *handle, u64 size_to_read, void* data );
 
+/**
+  @brief Gets a view of the contents of a file that was read, nothing is copied
+
+  @param handle - the file handle to view
+  @return string_view - view of the file data, valid until the handle is closed
+*/
+FZY_API string_view file_get_view( file_handle *handle );
+
+/**
+  @brief Reads the next line of a file that was read without copying it, the line ending
+    ( \n or \r\n ) is not part of the line
+
+  @param handle - the file handle to read the line from
+  @param out_line - receives a view of the line, valid until the handle is closed
+  @return b8 - false once every line has been read
+*/
+FZY_API b8 file_read_line( file_handle *handle, string_view* out_line );
+
 /**
   @brief Adds data to a file handle to write
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief A map from u64 keys ( GL ids, entities, type ids, interned names ) to fixed-size values
+    stored inline in the map.  Uses Robin Hood open addressing over power-of-two arrays and never
+    allocates per entry.  Values move when the map grows or an entry is removed, so pointers
+    returned by the map are only valid until the next insert or remove
+*/
+typedef struct hashmap hashmap;
+
+/*
+  @brief Creates a new hashmap, use hashmap_create instead
+
+  @param value_size The size of each value in the map
+  @param capacity The number of entries to make room for before growing
+  @param memory_tag The memory tag for the map
+  @param file The source file creating the map, supplied by the hashmap_create macro
+  @param line The source line creating the map, supplied by the hashmap_create macro
+  @return Pointer - Points to the created map
+*/
+FZY_API hashmap *_hashmap_create( u64 value_size, u32 capacity, u16 memory_tag, const char *file, u32 line );
+
+/*
+  @brief Creates a new hashmap whose memory comes from the given allocator, use
+    hashmap_create_with_allocator instead
+
+  @param value_size The size of each value in the map
+  @param capacity The number of entries to make room for before growing
+  @param allocator The allocator for the map's memory, copied into the map
+  @param file The source file creating the map, supplied by the hashmap_create_with_allocator macro
+  @param line The source line creating the map, supplied by the hashmap_create_with_allocator macro
+  @return Pointer - Points to the created map or 0 if the allocator failed
+*/
+FZY_API hashmap *_hashmap_create_with_allocator( u64 value_size, u32 capacity, const memory_allocator* allocator,
+                                                 const char *file, u32 line );
+
+/*
+  @brief Frees all memory held by the map
+
+  @param map The map to release
+*/
+FZY_API void hashmap_destroy( hashmap *map );
+
+/*
+  @brief Copies the value into the map at the key, replacing any value already there
+
+  @param map The map to access
+  @param key The key to store the value at
+  @param value Pointer to the value to copy, 0 to store a zeroed value
+  @return Ptr - Points to the value inside the map
+*/
+FZY_API void *hashmap_insert( hashmap *map, u64 key, const void *value );
+
+/*
+  @brief Returns the value stored at the key
+
+  @param map The map to access
+  @param key The key to look up
+  @return Ptr - Points to the value inside the map, or 0 if the key is not in the map
+*/
+FZY_API void *_hashmap_get( hashmap *map, u64 key );
+
+/*
+  @brief Checks if the key is in the map
+
+  @param map The map to access
+  @param key The key to look up
+  @return b8 - True if the key is in the map
+*/
+FZY_API b8 hashmap_contains( hashmap *map, u64 key );
+
+/*
+  @brief Removes the key from the map
+
+  @param map The map to access
+  @param key The key to remove
+  @param out_value Receives a copy of the removed value, may be 0
+  @return b8 - True if the key was in the map
+*/
+FZY_API b8 hashmap_remove( hashmap *map, u64 key, void *out_value );
+
+/*
+  @brief Returns the number of entries in the map
+
+  @param map The map to access
+  @return The number of entries
+*/
+FZY_API u32 hashmap_count( hashmap *map );
+
+/*
+  @brief Removes every entry, the memory is kept for reuse
+
+  @param map The map to access
+*/
+FZY_API void hashmap_clear( hashmap *map );
+
+// Macros -----------------
+#define hashmap_create( type, capacity, tag ) _hashmap_create( sizeof( type ), capacity, tag, __FILE__, __LINE__ )
+#define hashmap_create_with_allocator( type, capacity, allocator ) _hashmap_create_with_allocator( sizeof( type ), capacity, allocator, __FILE__, __LINE__ )
+#define hashmap_get( type, map, key ) ((type*)_hashmap_get( map, key ))
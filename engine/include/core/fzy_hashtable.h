@@ -1,22 +1,61 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_name.h"
 
 /**
-  @brief Represents a hashtable for fast lookups, uses chaining for
-      collision resolution
+  @brief Represents a hashtable for fast lookups, uses Robin Hood open addressing over a
+      single power-of-two slot array and doubles once it is 7/8 full
 */
 typedef struct hashtable_t hashtable;
 
+/* @brief Occupancy statistics for a hashtable */
+typedef struct hashtable_stats
+{
+  u32 count;              // number of keys in the table
+  u32 capacity;           // number of slots in the table
+  u32 longest_probe;      // most slots a lookup of any key visits
+  f32 load_factor;        // count / capacity
+  f32 average_probe;      // slots a lookup of a present key visits on average
+  u64 memory;             // bytes held by the table, its slots, tags and key names
+
+} hashtable_stats;
 
 /**
-  @brief Creates a new hashtable and returns a pointer to it
-  @param capacity The initialize size of the table
-  @param memory_tag The memory scope to assign this table to
-  @param destroy_func Function to free memory held in the table
+  @brief Walks the keys of a hashtable without allocating, the table must not be changed while
+    iterating.  Start with hashtable_iterate and call hashtable_next until it returns false
+*/
+typedef struct hashtable_iterator
+{
+  hashtable* table;
+  u32 index;              // next slot to visit
+  const char* key;        // key of the current entry
+  void* value;            // value of the current entry
+  u32 ref_count;          // reference count of the current entry
+
+} hashtable_iterator;
+
+
+/**
+  @brief Creates a new hashtable and returns a pointer to it, should only be used internally, Use
+    hashtable_create instead
+  @param capacity The initialize size of the table, rounded up to a power of two
+  @param file The source file creating the table, supplied by the hashtable_create macro
+  @param line The source line creating the table, supplied by the hashtable_create macro
   @return Pointer to the hashtable
 */
-FZY_API hashtable *hashtable_create( u32 capacity );
+FZY_API hashtable *_hashtable_create( u32 capacity, const char* file, u32 line );
+
+/**
+  @brief Creates a new hashtable whose table, slots and key names come from the given allocator
+  @param capacity The initialize size of the table, rounded up to a power of two
+  @param allocator The allocator for the table's memory, copied into the table
+  @param file The source file creating the table, supplied by the hashtable_create_with_allocator macro
+  @param line The source line creating the table, supplied by the hashtable_create_with_allocator macro
+  @return Pointer to the hashtable or 0 if the allocator failed
+*/
+FZY_API hashtable *_hashtable_create_with_allocator( u32 capacity, const memory_allocator* allocator, const char* file, u32 line );
 
 /**
   @brief Frees the hashtable, has ability to provide a free function for the
@@ -32,18 +71,36 @@ FZY_API void hashtable_destroy( hashtable *table, void (*destroy_fn)(void*) );
   @param table - The table to access
   @param key - the key to the item
   @param value - the value to set the resource to
-  @return u64 - hash value to the resource
+  @return b8 - false if the key is null or the table couldn't grow to hold it
 */
-FZY_API void hashtable_set( hashtable *table, const char *key, void* value );
+FZY_API b8 hashtable_set( hashtable *table, const char *key, void* value );
 
 /**
   @brief Retrieve the value stored at the key in the hashtable, will increament the reference count
   @param table - the hashtabel to access
   @param key - the key to access
-  @return Ptr - pointer to the element at the key
+  @return Ptr - pointer to the element at the key, NULL if the key is missing or NULL
 */
 FZY_API void *hashtable_get( hashtable *table, const char* key );
 
+/**
+  @brief Retrieve the value stored at the key whose name_id is id, without hashing a string.
+    Will increament the reference count
+  @param table - the hashtabel to access
+  @param id - the name_id of the key, from name_intern, name_hash or FZY_NAME
+  @return Ptr - pointer to the element at the key
+*/
+FZY_API void *hashtable_get_id( hashtable *table, name_id id );
+
+/**
+  @brief Retrieve the value stored at the key held in a view, the key does not need to be null
+    terminated.  Will increament the reference count
+  @param table - the hashtabel to access
+  @param key - view of the key to access
+  @return Ptr - pointer to the element at the key, NULL if the key is missing or the view has no data
+*/
+FZY_API void *hashtable_get_view( hashtable *table, string_view key );
+
 /**
   @brief Removes the value at the key and returns it, will decrement the reference count
     sets the value at the key to null
@@ -51,3 +108,36 @@ FZY_API void *hashtable_get( hashtable *table, const char* key );
   @param key - the key to remove
 */
 FZY_API void* hashtable_remove( hashtable* table, const char* key );
+
+/**
+  @brief Grows the table so it holds count keys without growing again
+  @param table - The table to access
+  @param count - the number of keys to make room for
+  @return b8 - false if the allocation failed, the table is unchanged
+*/
+FZY_API b8 hashtable_reserve( hashtable* table, u32 count );
+
+/**
+  @brief Starts an iteration over the table, does not reference any entry
+  @param table - The table to walk
+  @return hashtable_iterator - pass to hashtable_next to reach the first entry
+*/
+FZY_API hashtable_iterator hashtable_iterate( hashtable* table );
+
+/**
+  @brief Advances the iterator to the next entry, filling in its key, value and reference count
+  @param it - the iterator to advance
+  @return b8 - false once every entry has been visited
+*/
+FZY_API b8 hashtable_next( hashtable_iterator* it );
+
+/**
+  @brief Gets the occupancy statistics of the table, walks every slot
+  @param table - The table to query
+  @return hashtable_stats - the current statistics of the table
+*/
+FZY_API hashtable_stats hashtable_get_stats( hashtable* table );
+
+// Macros -----------------
+#define hashtable_create( capacity ) _hashtable_create( capacity, __FILE__, __LINE__ )
+#define hashtable_create_with_allocator( capacity, allocator ) _hashtable_create_with_allocator( capacity, allocator, __FILE__, __LINE__ )
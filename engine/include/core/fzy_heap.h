@@ -0,0 +1,136 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief A d-ary heap ( priority queue ) of fixed-size elements.  The element the comparator
+    orders first is always at the top, push and pop are O( log n ).  Every push returns a handle
+    that stays valid until the element is popped or removed, use it to find the element again and
+    re-sort it after its priority changes ( decrease-key ) without a linear scan
+*/
+typedef struct heap heap;
+
+/* @brief Identifies an element in a heap */
+typedef u32 heap_handle;
+
+/* @brief Returned by heap_push when the heap could not grow */
+#define HEAP_INVALID_HANDLE 0xffffffffu
+
+/* @brief Arity used when 0 is passed to heap_create, 4 keeps more of the children on one cache line */
+#define HEAP_DEFAULT_ARITY 4
+
+/*
+  @brief Orders two elements
+  @return i32 - negative if a comes out before b, positive if after, 0 if either order is fine
+*/
+typedef i32 (*heap_compare)( const void* a, const void* b );
+
+/*
+  @brief Creates a new heap, Use heap_create instead
+
+  @param element_size The size of each element in the heap
+  @param arity The number of children per node, 2 to 16, 0 for HEAP_DEFAULT_ARITY
+  @param compare Orders the elements, the first element is at the top
+  @param memory_tag The memory tag for the heap
+  @param file The source file creating the heap, supplied by the heap_create macro
+  @param line The source line creating the heap, supplied by the heap_create macro
+  @return Pointer - Points to the created heap
+*/
+FZY_API heap *_heap_create( u64 element_size, u32 arity, heap_compare compare, u16 memory_tag, const char *file, u32 line );
+
+/*
+  @brief Creates a new heap whose memory comes from the given allocator, Use
+    heap_create_with_allocator instead
+
+  @param element_size The size of each element in the heap
+  @param arity The number of children per node, 2 to 16, 0 for HEAP_DEFAULT_ARITY
+  @param compare Orders the elements, the first element is at the top
+  @param allocator The allocator for the heap's memory, copied into the heap
+  @param file The source file creating the heap, supplied by the heap_create_with_allocator macro
+  @param line The source line creating the heap, supplied by the heap_create_with_allocator macro
+  @return Pointer - Points to the created heap or 0 if the allocator failed
+*/
+FZY_API heap *_heap_create_with_allocator( u64 element_size, u32 arity, heap_compare compare, const memory_allocator* allocator,
+                                           const char *file, u32 line );
+
+/*
+  @brief Frees all memory held by the heap
+
+  @param heap The heap to release
+*/
+FZY_API void heap_destroy( heap *heap );
+
+/*
+  @brief Copies the element into the heap
+
+  @param heap The heap to access
+  @param element Pointer to the element to add ( memcpy )
+  @return heap_handle - Identifies the element until it leaves the heap, HEAP_INVALID_HANDLE on failure
+*/
+FZY_API heap_handle heap_push( heap *heap, const void *element );
+
+/*
+  @brief Removes the top element
+
+  @param heap The heap to access
+  @param out Receives a copy of the top element, may be 0
+  @return b8 - false if the heap is empty
+*/
+FZY_API b8 heap_pop( heap *heap, void *out );
+
+/*
+  @brief Returns the top element without removing it
+
+  @param heap The heap to access
+  @return Ptr - Points to the top element, or 0 if the heap is empty.  Valid until the heap changes
+*/
+FZY_API void *heap_peek( heap *heap );
+
+/*
+  @brief Returns the element with the handle, change its priority through the pointer and then
+    call heap_update
+
+  @param heap The heap to access
+  @param handle The handle returned by heap_push
+  @return Ptr - Points to the element.  Valid until the heap changes
+*/
+FZY_API void *_heap_get( heap *heap, heap_handle handle );
+
+/*
+  @brief Moves the element with the handle to its place after its priority changed, works for
+    both a raised and a lowered priority
+
+  @param heap The heap to access
+  @param handle The handle returned by heap_push
+*/
+FZY_API void heap_update( heap *heap, heap_handle handle );
+
+/*
+  @brief Removes the element with the handle from anywhere in the heap
+
+  @param heap The heap to access
+  @param handle The handle returned by heap_push
+  @param out Receives a copy of the element, may be 0
+*/
+FZY_API void heap_remove( heap *heap, heap_handle handle, void *out );
+
+/*
+  @brief Returns the number of elements in the heap
+
+  @param heap The heap to access
+  @return The number of elements
+*/
+FZY_API u32 heap_size( heap *heap );
+
+/*
+  @brief Removes every element, every handle becomes invalid.  The memory is kept for reuse
+
+  @param heap The heap to access
+*/
+FZY_API void heap_clear( heap *heap );
+
+// Macros -----------------
+#define heap_create( type, arity, compare, tag ) _heap_create( sizeof( type ), arity, compare, tag, __FILE__, __LINE__ )
+#define heap_create_with_allocator( type, arity, compare, allocator ) _heap_create_with_allocator( sizeof( type ), arity, compare, allocator, __FILE__, __LINE__ )
+#define heap_get( type, heap, handle ) ((type*)_heap_get( heap, handle ))
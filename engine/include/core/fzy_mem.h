@@ -21,11 +21,96 @@ typedef enum fzy_memory_tag {
     MEM_TAG_ENTITY,
     MEM_TAG_COMPONENT,
     MEM_TAG_PROCESS,
+    MEM_TAG_SCRATCH,
 
     MEM_TAG_MAX_TAGS
 
 } fzy_memory_tag;
 
+/* @brief Size in bytes of the per-frame linear arena, reset once per frame by fzy_update */
+#ifndef FZY_FRAME_ARENA_SIZE
+#define FZY_FRAME_ARENA_SIZE ( 8 * 1024 * 1024 )
+#endif
+
+/* @brief Size in bytes of each thread's scratch stack, created on first use by memory_scratch_stack */
+#ifndef FZY_SCRATCH_STACK_SIZE
+#define FZY_SCRATCH_STACK_SIZE ( 16 * 1024 * 1024 )
+#endif
+
+/* @brief Huge allocations, virtual arenas and the frame arena of at least this many bytes are backed
+    by huge pages where the host allows it, define as 0 to disable huge pages */
+#ifndef FZY_HUGE_PAGE_THRESHOLD
+#define FZY_HUGE_PAGE_THRESHOLD ( 2 * 1024 * 1024 )
+#endif
+
+/* @brief Alignment for 128 bit SIMD loads ( vec4, mat4 ) */
+#define MEMORY_ALIGNMENT_SIMD 16
+
+/* @brief Alignment for 256 bit SIMD loads */
+#define MEMORY_ALIGNMENT_AVX 32
+
+/* @brief Alignment to a cache line, avoids blocks splitting cache lines */
+#define MEMORY_ALIGNMENT_CACHE_LINE 64
+
+/* @brief The live tracked allocations grouped by call site at a point in time */
+typedef struct memory_snapshot memory_snapshot;
+
+/* @brief A reserved range of address space, pages are committed as the arena grows so its
+    contents never move.  Only committed pages count towards the tag statistics */
+typedef struct virtual_arena
+{
+  u8* base;             // start of the reserved range
+  u64 reserved;         // size in bytes of the reserved range
+  u64 committed;        // bytes at the start of the range backed by memory
+  u64 used;             // bytes handed out by virtual_arena_push
+  fzy_memory_tag tag;   // indicates the use of the arena
+  b8 huge_pages;        // the range was advised for huge pages, commits are made a huge page at a time
+
+} virtual_arena;
+
+/* @brief A fixed block handed out in LIFO order from both ends, the bottom and top grow towards
+    each other.  Blocks are released by freeing back to a marker.  Not thread safe */
+typedef struct memory_stack
+{
+  u8* memory;           // the backing block
+  u64 capacity;         // size in bytes of the backing block
+  u64 bottom;           // offset of the first free byte above the bottom allocations
+  u64 top;              // offset of the last top allocation, capacity when empty
+  fzy_memory_tag tag;   // indicates the use of the stack
+  b8 owns_memory;       // false when the stack was created over a caller's buffer
+
+} memory_stack;
+
+/* @brief A position in one end of a memory stack, everything allocated after it is freed together */
+typedef u64 memory_stack_marker;
+
+/* @brief A fixed-size block allocator with O(1) allocation and free, grows a chunk at a time.
+    A pool is not thread safe, use one pool per thread */
+typedef struct memory_pool memory_pool;
+
+/* @brief Allocation callbacks a container is constructed with, so its storage can come from the heap,
+    the frame arena, a stack, a pool or a fixed buffer.  Blocks are not zeroed.  file and line name
+    the call site the block is charged to in the allocation tracker, containers pass the site that
+    created them */
+typedef struct memory_allocator
+{
+  void* (*allocate)( void* context, u64 size, const char* file, u32 line );                                   // returns 0 on failure
+  void* (*reallocate)( void* context, void* block, u64 old_size, u64 new_size, const char* file, u32 line );  // keeps the first old_size bytes
+  void (*free)( void* context, void* block, u64 size );                                                       // may do nothing
+  void* context;                                                                                             // passed to every callback
+
+} memory_allocator;
+
+/* @brief Occupancy statistics for a memory pool */
+typedef struct memory_pool_stats
+{
+  u64 block_size;   // size in bytes of each block, after padding
+  u32 capacity;     // number of blocks held by the pool
+  u32 used;         // number of blocks currently handed out
+  u32 peak;         // the most blocks handed out at once
+
+} memory_pool_stats;
+
 /*
   @brief Initializes the memory system
 */
@@ -37,17 +122,37 @@ FZY_API b8 memory_initialize( );
 FZY_API b8 memory_shutdown( );
 
 /*
-  @brief Preforms a memory allocation from the host of the given size. Tracked by memory_tag
+  @brief Releases the small blocks cached by the calling thread.  Worker threads must call this
+    before they exit, the main thread is flushed by memory_shutdown
+*/
+FZY_API void memory_thread_shutdown( void );
+
+/*
+  @brief Preforms a memory allocation from the host of the given size. Tracked by memory_tag.
+    Safe to call from any thread, small blocks are served from a per-thread cache
   @param size - size in bytes to be allocated
   @param tag - indicates the use of the block
+  @param file - the source file making the allocation, supplied by the memory_allocate macro
+  @param line - the source line making the allocation, supplied by the memory_allocate macro
   @returns Pointer to the allocated memory
 */
-FZY_API void* memory_allocate( u64 size, fzy_memory_tag tag );
+FZY_API void* _memory_allocate( u64 size, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Preforms an allocation from the host of the given size without zeroing it. Tracked by
+    memory_tag.  Use for buffers that are written before they are read
+  @param size - size in bytes to be allocated
+  @param tag - indicates the use of the block
+  @param file - the source file making the allocation, supplied by the memory_allocate_uninitialized macro
+  @param line - the source line making the allocation, supplied by the memory_allocate_uninitialized macro
+  @returns Pointer to the allocated memory
+*/
+FZY_API void* _memory_allocate_uninitialized( u64 size, fzy_memory_tag tag, const char* file, u32 line );
 
 /*
   @brief Frees the block of memory
   @param block - the memory to be free
-  @param size - size in bytes to be freed
+  @param size - size in bytes to be freed, must match the size it was allocated with
   @param tag - indicates the use of the memory block
 */
 FZY_API void memory_delete( void *block, u64 size, fzy_memory_tag tag );
@@ -58,9 +163,89 @@ FZY_API void memory_delete( void *block, u64 size, fzy_memory_tag tag );
   @param old_size The size of the block before reallocation
   @param new_size The size the block is reallocating to
   @param tag The memory tag for the allocation
+  @param file - the source file making the allocation, supplied by the memory_reallocate macro
+  @param line - the source line making the allocation, supplied by the memory_reallocate macro
+  @return Pointer to the memory block
+*/
+FZY_API void* _memory_reallocate( void* block, u64 old_size, u64 new_size, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Preforms an aligned allocation from the host of the given size. Tracked by memory_tag.
+    Must be freed with memory_delete_aligned
+  @param size - size in bytes to be allocated
+  @param alignment - alignment in bytes of the block, must be a power of two ( see memory_page_size )
+  @param tag - indicates the use of the block
+  @param file - the source file making the allocation, supplied by the memory_allocate_aligned macro
+  @param line - the source line making the allocation, supplied by the memory_allocate_aligned macro
+  @returns Pointer to the allocated memory
+*/
+FZY_API void* _memory_allocate_aligned( u64 size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Preforms an aligned allocation without zeroing it. Must be freed with memory_delete_aligned
+  @param size - size in bytes to be allocated
+  @param alignment - alignment in bytes of the block, must be a power of two
+  @param tag - indicates the use of the block
+  @param file - the source file making the allocation, supplied by the memory_allocate_aligned_uninitialized macro
+  @param line - the source line making the allocation, supplied by the memory_allocate_aligned_uninitialized macro
+  @returns Pointer to the allocated memory
+*/
+FZY_API void* _memory_allocate_aligned_uninitialized( u64 size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Frees a block allocated with memory_allocate_aligned
+  @param block - the memory to be free
+  @param size - size in bytes to be freed
+  @param alignment - the alignment the block was allocated with
+  @param tag - indicates the use of the memory block
+*/
+FZY_API void memory_delete_aligned( void *block, u64 size, u64 alignment, fzy_memory_tag tag );
+
+/*
+  @brief Reallocates an aligned block to the new size, keeping its alignment
+  @param block The memory block to reallocate
+  @param old_size The size of the block before reallocation
+  @param new_size The size the block is reallocating to
+  @param alignment The alignment the block was allocated with
+  @param tag The memory tag for the allocation
+  @param file - the source file making the allocation, supplied by the memory_reallocate_aligned macro
+  @param line - the source line making the allocation, supplied by the memory_reallocate_aligned macro
   @return Pointer to the memory block
 */
-FZY_API void* memory_reallocate( void* block, u64 old_size, u64 new_size, fzy_memory_tag tag );
+FZY_API void* _memory_reallocate_aligned( void* block, u64 old_size, u64 new_size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Gets the page size of the host, used for page aligned allocations
+  @return u64 - the page size in bytes
+*/
+FZY_API u64 memory_page_size( void );
+
+/*
+  @brief Gets the huge page size of the host, the granularity of huge page backed blocks
+  @return u64 - the huge page size in bytes
+*/
+FZY_API u64 memory_huge_page_size( void );
+
+/*
+  @brief Allocates a large zeroed block straight from the OS, backed by huge pages when the size is at
+    least FZY_HUGE_PAGE_THRESHOLD.  Explicit huge pages are tried first, then transparent huge pages.
+    Use for big buffers that are accessed randomly.  Must be freed with memory_delete_huge,
+    should only be used internally, Use memory_allocate_huge instead
+  @param size - size in bytes to be allocated
+  @param tag - indicates the use of the block
+  @param file - the source file making the allocation, supplied by the memory_allocate_huge macro
+  @param line - the source line making the allocation, supplied by the memory_allocate_huge macro
+  @return Pointer to the memory block, page aligned
+*/
+FZY_API void* _memory_allocate_huge( u64 size, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Frees a block allocated with memory_allocate_huge
+  @param block - the block to free
+  @param size - the size passed to memory_allocate_huge
+  @param tag - the tag passed to memory_allocate_huge
+*/
+FZY_API void memory_delete_huge( void* block, u64 size, fzy_memory_tag tag );
 
 /*
   @brief Compares the data at the two address and returns 0 if equal
@@ -87,6 +272,15 @@ FZY_API void* memory_zero( void *block, u64 size );
 */
 FZY_API void* memory_copy( void *dest, const void *source, u64 size );
 
+/*
+  @brief Copy the memory from the source to the dest, the ranges may overlap
+  @param dest - location to move memory to
+  @param source - memory to move
+  @param size - size in bytes to move
+  @return Pointer to the dest
+*/
+FZY_API void* memory_move( void *dest, const void *source, u64 size );
+
 /*
   @brief Sets the memory to the value given
   @param dest - pointer to the memory to set
@@ -96,9 +290,293 @@ FZY_API void* memory_copy( void *dest, const void *source, u64 size );
 */
 FZY_API void *memory_set( void *dest, i32 value, u64 size );
 
+/*
+  @brief Allocates a block from the per-frame linear arena.  The block is only valid until the
+    end of the current frame and is not zeroed.  Never pass it to memory_delete.  Safe to call
+    from any thread
+  @param size - size in bytes to be allocated
+  @param tag - indicates the use of the block
+  @returns Pointer to the allocated memory or 0 if the arena is exhausted
+*/
+FZY_API void* memory_frame_allocate( u64 size, fzy_memory_tag tag );
+
+/*
+  @brief Gets the largest number of bytes used by the frame arena in a single frame
+  @returns u64 - the high-water mark of the frame arena in bytes
+*/
+FZY_API u64 memory_frame_high_water( void );
+
+/*
+  @brief Releases every block allocated from the frame arena this frame and fires the budget
+    events latched during it.  Called by fzy_update at the end of each frame, no other thread may
+    allocate from the arena during the reset
+*/
+FZY_API void memory_frame_reset( void );
+
+/*
+  @brief Reserves address space for an arena without committing any memory
+  @param arena - the arena to initialize
+  @param reserve_size - the most bytes the arena can ever hold, rounded up to the page size
+  @param tag - indicates the use of the arena
+  @returns b8 - true if the range was reserved
+*/
+FZY_API b8 virtual_arena_create( virtual_arena* arena, u64 reserve_size, fzy_memory_tag tag );
+
+/*
+  @brief Releases the reserved range and every committed page
+  @param arena - the arena to destroy
+*/
+FZY_API void virtual_arena_destroy( virtual_arena* arena );
+
+/*
+  @brief Ensures the first size bytes of the arena are committed, the contents of the arena
+    do not move
+  @param arena - the arena to grow
+  @param size - number of bytes from the start of the arena that must be usable
+  @returns b8 - false if size is larger than the reservation or the commit failed
+*/
+FZY_API b8 virtual_arena_commit( virtual_arena* arena, u64 size );
+
+/*
+  @brief Takes the next size bytes of the arena, committing pages as needed
+  @param arena - the arena to allocate from
+  @param size - size in bytes of the block
+  @returns Pointer to the block or 0 if the reservation is exhausted
+*/
+FZY_API void* virtual_arena_push( virtual_arena* arena, u64 size );
+
+/*
+  @brief Releases every block pushed onto the arena, committed pages are kept for reuse
+  @param arena - the arena to reset
+*/
+FZY_API void virtual_arena_reset( virtual_arena* arena );
+
+/*
+  @brief Allocates the backing block for a stack allocator
+  @param stack - the stack to create
+  @param size - size in bytes shared by both ends of the stack
+  @param tag - indicates the use of the stack
+  @returns b8 - true if the block was allocated
+*/
+FZY_API b8 memory_stack_create( memory_stack* stack, u64 size, fzy_memory_tag tag );
+
+/*
+  @brief Initializes a stack allocator over memory owned by the caller, such as a static array.
+    memory_stack_destroy does not free the buffer
+  @param stack - the stack to create
+  @param buffer - the memory to hand out, aligned to 16 bytes
+  @param size - size in bytes of the buffer
+  @returns b8 - true if the stack was initialized
+*/
+FZY_API b8 memory_stack_create_from_buffer( memory_stack* stack, void* buffer, u64 size );
+
+/*
+  @brief Frees the backing block of a stack, every block handed out by it is invalid afterwards
+  @param stack - the stack to destroy
+*/
+FZY_API void memory_stack_destroy( memory_stack* stack );
+
+/*
+  @brief Hands out a block from the bottom of the stack, aligned to 16 bytes
+  @param stack - the stack to allocate from
+  @param size - size in bytes of the block
+  @returns Pointer to the block, or 0 when the ends of the stack would meet
+*/
+FZY_API void* memory_stack_allocate( memory_stack* stack, u64 size );
+
+/*
+  @brief Hands out a block from the top of the stack, aligned to 16 bytes.  Use the top for
+    results that outlive the scratch work done on the bottom
+  @param stack - the stack to allocate from
+  @param size - size in bytes of the block
+  @returns Pointer to the block, or 0 when the ends of the stack would meet
+*/
+FZY_API void* memory_stack_allocate_top( memory_stack* stack, u64 size );
+
+/*
+  @brief Obtains a marker for the current position of the bottom of the stack
+  @param stack - the stack to mark
+  @returns memory_stack_marker - pass to memory_stack_free_to_marker
+*/
+FZY_API memory_stack_marker memory_stack_get_marker( memory_stack* stack );
+
+/*
+  @brief Obtains a marker for the current position of the top of the stack
+  @param stack - the stack to mark
+  @returns memory_stack_marker - pass to memory_stack_free_to_marker_top
+*/
+FZY_API memory_stack_marker memory_stack_get_marker_top( memory_stack* stack );
+
+/*
+  @brief Frees every bottom block allocated after the marker was taken
+  @param stack - the stack to free from
+  @param marker - a marker from memory_stack_get_marker
+*/
+FZY_API void memory_stack_free_to_marker( memory_stack* stack, memory_stack_marker marker );
+
+/*
+  @brief Frees every top block allocated after the marker was taken
+  @param stack - the stack to free from
+  @param marker - a marker from memory_stack_get_marker_top
+*/
+FZY_API void memory_stack_free_to_marker_top( memory_stack* stack, memory_stack_marker marker );
+
+/*
+  @brief Obtains the calling thread's scratch stack, created on first use with FZY_SCRATCH_STACK_SIZE
+    bytes.  Loaders take a marker, allocate their temporaries and free back to the marker when done
+  @returns Pointer to the scratch stack, or 0 if it could not be created
+*/
+FZY_API memory_stack* memory_scratch_stack( void );
+
+/*
+  @brief Creates a pool of fixed-size blocks, should only be used internally, Use memory_pool_create instead
+  @param block_size - size in bytes of each block
+  @param blocks_per_chunk - number of blocks allocated each time the pool runs out
+  @param tag - indicates the use of the pool
+  @param file - the source file creating the pool, supplied by the memory_pool_create macro
+  @param line - the source line creating the pool, supplied by the memory_pool_create macro
+  @returns Pointer to the new pool
+*/
+FZY_API memory_pool* _memory_pool_create( u64 block_size, u32 blocks_per_chunk, fzy_memory_tag tag, const char* file, u32 line );
+
+/*
+  @brief Creates a pool whose header and chunks come from the given allocator, should only be used
+    internally, Use memory_pool_create_with_allocator instead
+  @param block_size - size in bytes of each block
+  @param blocks_per_chunk - number of blocks allocated each time the pool runs out
+  @param allocator - the allocator for the pool's memory, copied into the pool
+  @param file - the source file creating the pool, supplied by the memory_pool_create_with_allocator macro
+  @param line - the source line creating the pool, supplied by the memory_pool_create_with_allocator macro
+  @returns Pointer to the new pool
+*/
+FZY_API memory_pool* _memory_pool_create_with_allocator( u64 block_size, u32 blocks_per_chunk, const memory_allocator* allocator,
+                                                         const char* file, u32 line );
+
+/*
+  @brief Frees the pool and every block allocated from it
+  @param pool - the pool to destroy
+*/
+FZY_API void memory_pool_destroy( memory_pool* pool );
+
+/*
+  @brief Takes a block from the pool, growing the pool by a chunk if it is empty
+  @param pool - the pool to allocate from
+  @param zero - indicates if the block should be zeroed
+  @returns Pointer to the block
+*/
+FZY_API void* memory_pool_allocate( memory_pool* pool, b8 zero );
+
+/*
+  @brief Returns a block to the pool it was allocated from
+  @param pool - the pool that owns the block
+  @param block - the block to release
+*/
+FZY_API void memory_pool_free( memory_pool* pool, void* block );
+
+/*
+  @brief Gets the occupancy statistics of the pool
+  @param pool - the pool to query
+  @returns memory_pool_stats - the current statistics of the pool
+*/
+FZY_API memory_pool_stats memory_pool_get_stats( memory_pool* pool );
+
+/*
+  @brief Sets the byte budgets for a memory tag, a limit of 0 disables it.  Crossing the soft
+    limit raises FZY_EVENT_CODE_MEMORY_SOFT_BUDGET, an allocation that would cross the hard limit
+    raises FZY_EVENT_CODE_MEMORY_HARD_BUDGET and fails, returning 0.  The allocating thread only
+    latches the event, memory_frame_reset fires it on the main thread at most once per frame and tag
+  @param tag - the memory tag to budget
+  @param soft_limit - bytes in use before listeners are asked to release memory
+  @param hard_limit - bytes in use the tag can never exceed
+*/
+FZY_API void memory_set_budget( fzy_memory_tag tag, u64 soft_limit, u64 hard_limit );
+
+/*
+  @brief Obtains the number of bytes currently allocated with a memory tag
+  @param tag - the memory tag to query
+  @returns u64 - the bytes in use
+*/
+FZY_API u64 memory_get_tag_usage( fzy_memory_tag tag );
+
+/*
+  @brief Obtains an allocator that uses memory_allocate and friends, the default for containers
+  @param tag - the memory tag for every block
+  @returns memory_allocator - the allocator
+*/
+FZY_API memory_allocator memory_allocator_heap( fzy_memory_tag tag );
+
+/*
+  @brief Obtains an allocator over the frame arena, freeing does nothing and every block is released
+    by memory_frame_reset.  A container using it must not outlive the frame
+  @param tag - the memory tag for every block
+  @returns memory_allocator - the allocator
+*/
+FZY_API memory_allocator memory_allocator_frame( fzy_memory_tag tag );
+
+/*
+  @brief Obtains an allocator over the bottom of a stack.  Freeing does nothing, free the stack to
+    a marker instead.  Reallocating the most recent block grows it in place
+  @param stack - the stack to allocate from, created from the heap or from a fixed buffer
+  @returns memory_allocator - the allocator
+*/
+FZY_API memory_allocator memory_allocator_stack( memory_stack* stack );
+
+/*
+  @brief Obtains an allocator over a pool, requests larger than the pool's block size fail
+  @param pool - the pool to allocate from
+  @returns memory_allocator - the allocator
+*/
+FZY_API memory_allocator memory_allocator_pool( memory_pool* pool );
+
 /*
   @brief Obtains a string containing a "printout" of memory usage, categorized by
-    memory tag. The memory should be freed by the caller.
+    memory tag. The string should be freed by the caller with string_free.
   @returns The total count of allocations since the system's initialization.
 */
 FZY_API char* memory_get_usage_str( );
+
+/*
+  @brief Enables or disables recording every live allocation with its call site.  Enabled by
+    default in debug builds.  Blocks allocated while disabled are never reported
+  @param enable - true to start recording allocations
+*/
+FZY_API void memory_tracking_enable( b8 enable );
+
+/*
+  @brief Logs every live tracked allocation grouped by call site.  Called by memory_shutdown
+    to report leaks
+  @returns u64 - the number of live tracked allocations
+*/
+FZY_API u64 memory_report_leaks( void );
+
+/*
+  @brief Captures the live tracked allocations grouped by call site
+  @returns Pointer to the snapshot, free it with memory_snapshot_destroy
+*/
+FZY_API memory_snapshot* memory_snapshot_take( void );
+
+/*
+  @brief Frees a snapshot taken with memory_snapshot_take
+  @param snapshot - the snapshot to free
+*/
+FZY_API void memory_snapshot_destroy( memory_snapshot* snapshot );
+
+/*
+  @brief Obtains a string listing each call site whose live allocations changed between two
+    snapshots, largest growth first.  The string should be freed by the caller with string_free.
+  @param before - the earlier snapshot
+  @param after - the later snapshot
+  @returns Pointer to the string
+*/
+FZY_API char* memory_snapshot_diff_str( memory_snapshot* before, memory_snapshot* after );
+
+// Macros -----------------
+#define memory_allocate( size, tag ) _memory_allocate( size, tag, __FILE__, __LINE__ )
+#define memory_allocate_uninitialized( size, tag ) _memory_allocate_uninitialized( size, tag, __FILE__, __LINE__ )
+#define memory_reallocate( block, old_size, new_size, tag ) _memory_reallocate( block, old_size, new_size, tag, __FILE__, __LINE__ )
+#define memory_allocate_aligned( size, alignment, tag ) _memory_allocate_aligned( size, alignment, tag, __FILE__, __LINE__ )
+#define memory_allocate_aligned_uninitialized( size, alignment, tag ) _memory_allocate_aligned_uninitialized( size, alignment, tag, __FILE__, __LINE__ )
+#define memory_reallocate_aligned( block, old_size, new_size, alignment, tag ) _memory_reallocate_aligned( block, old_size, new_size, alignment, tag, __FILE__, __LINE__ )
+#define memory_allocate_huge( size, tag ) _memory_allocate_huge( size, tag, __FILE__, __LINE__ )
+#define memory_pool_create( type, blocks_per_chunk, tag ) _memory_pool_create( sizeof( type ), blocks_per_chunk, tag, __FILE__, __LINE__ )
+#define memory_pool_create_with_allocator( type, blocks_per_chunk, allocator ) _memory_pool_create_with_allocator( sizeof( type ), blocks_per_chunk, allocator, __FILE__, __LINE__ )
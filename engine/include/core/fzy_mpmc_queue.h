@@ -0,0 +1,65 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief A lock-free bounded FIFO any number of threads can push to and pop from.  Every slot
+    carries a sequence number that tells a thread whether the slot is ready to be written or
+    read, so producers and consumers only contend on a compare-exchange of their own index
+*/
+typedef struct mpmc_queue mpmc_queue;
+
+/**
+  @brief Creates a new mpmc queue, should only be used internally, Use mpmc_queue_create instead
+
+  @param type_size - the size of each element
+  @param capacity - the max number of elements, rounded up to a power of two
+  @param memory_tag - the memory tag to be used for this allocation
+  @return Ptr - pointer to the new queue or 0 if unsuccessful
+*/
+FZY_API mpmc_queue* _mpmc_queue_create( u32 type_size, u32 capacity, u8 memory_tag );
+
+/**
+  @brief Frees the memory associated with the queue, no thread may be using it
+
+  @param queue - the queue to destroy
+*/
+FZY_API void mpmc_queue_destroy( mpmc_queue* queue );
+
+/**
+  @brief Copies an element onto the back of the queue, safe from any thread
+
+  @param queue - the queue to access
+  @param data - the element to add
+  @return b8 - false if the queue is full
+*/
+FZY_API b8 mpmc_queue_push( mpmc_queue* queue, const void* data );
+
+/**
+  @brief Copies the front element out of the queue and removes it, safe from any thread
+
+  @param queue - the queue to access
+  @param out - receives the element
+  @return b8 - false if the queue is empty
+*/
+FZY_API b8 mpmc_queue_pop( mpmc_queue* queue, void* out );
+
+/**
+  @brief Returns the number of elements in the queue, only a snapshot while other threads are active
+
+  @param queue - the queue to access
+  @return u32 - the number of elements
+*/
+FZY_API u32 mpmc_queue_size( mpmc_queue* queue );
+
+/**
+  @brief Returns the number of elements the queue can hold
+
+  @param queue - the queue to access
+  @return u32 - the capacity
+*/
+FZY_API u32 mpmc_queue_capacity( mpmc_queue* queue );
+
+// Macros -----------------
+#define mpmc_queue_create( type, capacity, tag ) _mpmc_queue_create( sizeof( type ), capacity, tag )
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_string.h"
+
+/*
+  @brief A name turned into a stable 64 bit id.  The id is the FNV-1a hash of the text, the same
+    hash the hashtable uses for its keys, so an id can look up a hashtable entry directly
+*/
+typedef u64 name_id;
+
+/* @brief The longest literal FZY_NAME can hash, longer literals fail to compile */
+#define FZY_NAME_LITERAL_MAX 64
+
+/**
+  @brief Initializes the name interner
+  @returns b8 - true if successful
+*/
+b8 name_system_initialize( void );
+
+/**
+  @brief Shutdown the name interner, frees every interned string
+  @returns b8 - true if successful
+*/
+b8 name_system_shutdown( void );
+
+/*
+  @brief Hashes a string into its id without interning it
+
+  @param str - The string to hash
+  @return name_id - The id of the string
+*/
+FZY_API name_id name_hash( const char* str );
+
+/*
+  @brief Hashes the characters of a view into its id without interning it
+
+  @param view - The text to hash
+  @return name_id - The id of the text, equal to name_hash of the same characters
+*/
+FZY_API name_id name_hash_view( string_view view );
+
+/*
+  @brief Interns a string, later calls with the same text return the same id.  The text is
+    copied into storage reported under MEM_TAG_STRING and lives until shutdown
+
+  @param str - The string to intern
+  @return name_id - The id of the string
+*/
+FZY_API name_id name_intern( const char* str );
+
+/*
+  @brief Returns the interned text of an id
+
+  @param id - The id to look up
+  @return Ptr - The interned string, or 0 if the id was never interned
+*/
+FZY_API const char* name_string( name_id id );
+
+// Macros -----------------
+#define FZY__NAME_PRIME 1099511628211ULL
+#define FZY__NAME_BASIS 1469598103934665603ULL
+
+// one FNV-1a step, past the end of the literal it xors 0 and multiplies by 1 so the hash is unchanged
+#define FZY__NAME_STEP( h, s, i )                                                               \
+  ( ( (h) ^ (u64)(u8)( (i) < sizeof( s ) - 1 ? (s)[ (i) < sizeof( s ) ? (i) : 0 ] : 0 ) )       \
+    * ( (i) < sizeof( s ) - 1 ? FZY__NAME_PRIME : 1ULL ) )
+#define FZY__NAME_4( h, s, i )                                                                  \
+  FZY__NAME_STEP( FZY__NAME_STEP( FZY__NAME_STEP( FZY__NAME_STEP( h, s, i ), s, (i) + 1 ), s, (i) + 2 ), s, (i) + 3 )
+#define FZY__NAME_16( h, s, i )                                                                 \
+  FZY__NAME_4( FZY__NAME_4( FZY__NAME_4( FZY__NAME_4( h, s, i ), s, (i) + 4 ), s, (i) + 8 ), s, (i) + 12 )
+#define FZY__NAME_64( h, s, i )                                                                 \
+  FZY__NAME_16( FZY__NAME_16( FZY__NAME_16( FZY__NAME_16( h, s, i ), s, (i) + 16 ), s, (i) + 32 ), s, (i) + 48 )
+
+/*
+  @brief Hashes a string literal into its name_id, equal to name_hash( literal ).  The compiler
+    folds it to a constant and it can initialize statics, but it is not an integer constant
+    expression so it can't be a case label.  Use it for names known at compile time so per
+    frame code never hashes strings
+*/
+#define FZY_NAME( literal )                                                                     \
+  ( FZY__NAME_64( FZY__NAME_BASIS, "" literal, 0 )                                              \
+    * sizeof( char[ sizeof( "" literal ) <= FZY_NAME_LITERAL_MAX + 1 ? 1 : -1 ] ) )
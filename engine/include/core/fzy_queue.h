@@ -1,16 +1,22 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_mem.h"
 
+/*
+  @brief A FIFO ring buffer that doubles its capacity when a push does not fit.  Batches are
+    copied with at most two memory_copy calls, one on each side of the wrap
+*/
 typedef struct queue
 {
   u8 *data;
-  u32 front;
-  u32 rear;
+  u32 front;                    // slot of the oldest element
   u32 count;
   u32 capacity;
   u32 type_size;
-  u8 tag;
+  memory_allocator allocator;   // source of the queue and its data array
+  const char *file;             // call site that created the queue, its data arrays are charged to it
+  u32 line;
 
 } queue;
 
@@ -19,11 +25,26 @@ typedef struct queue
     internally, Use queue_create instead
 
   @param type_size - the size fo the data stored in the data array
-  @param capacity - the max number of item stored in the data array
+  @param capacity - the number of items the queue holds before it grows
   @param tag - the memory tag to be used for this allocation
+  @param file - the source file creating the queue, supplied by the queue_create macro
+  @param line - the source line creating the queue, supplied by the queue_create macro
+  @return Ptr - pointer to the new que or 0 if unsuccessful
+*/
+queue* _queue_create( u32 type_size, u32 capacity, u8 memory_tag, const char* file, u32 line );
+
+/**
+  @brief Creates a new queue whose memory comes from the given allocator, should only be used
+    internally, Use queue_create_with_allocator instead
+
+  @param type_size - the size fo the data stored in the data array
+  @param capacity - the number of items the queue holds before it grows
+  @param allocator - the allocator for the queue's memory, copied into the queue
+  @param file - the source file creating the queue, supplied by the queue_create_with_allocator macro
+  @param line - the source line creating the queue, supplied by the queue_create_with_allocator macro
   @return Ptr - pointer to the new que or 0 if unsuccessful
 */
-queue* _queue_create( u32 type_size, u32 capacity, u8 memory_tag );
+queue* _queue_create_with_allocator( u32 type_size, u32 capacity, const memory_allocator* allocator, const char* file, u32 line );
 
 /**
   @brief Frees the memory associated with the queue
@@ -49,7 +70,24 @@ b8 queue_is_empty( queue* queue );
 void* queue_get_front( queue *queue );
 
 /**
-  @brief Method to push the given data onto the array in the queue
+  @brief Returns the number of elements in the queue
+
+  @param queue - the queue to access
+  @return u32 - the number of elements
+*/
+u32 queue_size( queue* queue );
+
+/**
+  @brief Grows the queue so it holds capacity elements without growing again
+
+  @param queue - the queue to access
+  @param capacity - the number of elements to make room for
+  @return b8 - false if the allocation failed, the queue is unchanged
+*/
+b8 queue_reserve( queue* queue, u32 capacity );
+
+/**
+  @brief Method to push the given data onto the array in the queue, grows the queue when full
 
   @param queue - the queue to access
   @param data - the data to add to the queue
@@ -57,11 +95,53 @@ void* queue_get_front( queue *queue );
 void queue_push( queue *queue, const void* data );
 
 /**
-  @brief Pops the front fo the array
+  @brief Pushes count contiguous elements onto the back of the queue, grows the queue when full
+
+  @param queue - the queue to access
+  @param data - the first of the elements to add
+  @param count - the number of elements to add
+  @return b8 - false if the queue could not grow, nothing is added
+*/
+b8 queue_push_n( queue *queue, const void* data, u32 count );
+
+/**
+  @brief Pops the front of the queue, copying it out.  The old version returned a pointer into
+    the queue that the next push could overwrite
+
+  @param queue - the queue to access
+  @param out - receives a copy of the element, may be 0 to discard it
+  @return b8 - false if the queue is empty
+*/
+b8 queue_pop( queue* queue, void* out );
+
+/**
+  @brief Pops up to count elements from the front of the queue into out
+
+  @param queue - the queue to access
+  @param out - receives the elements, room for count elements, may be 0 to discard them
+  @param count - the most elements to pop
+  @return u32 - the number of elements popped
+*/
+u32 queue_pop_n( queue* queue, void* out, u32 count );
+
+/**
+  @brief Returns the contiguous run of elements at the front of the queue without popping them.
+    Read them in place and release them with queue_consume, a wrapped queue takes two spans
+
+  @param queue - the queue to access
+  @param count - receives the number of elements in the span
+  @return ptr - the front element, or 0 if the queue is empty
+*/
+void* queue_peek_span( queue* queue, u32* count );
+
+/**
+  @brief Drops count elements from the front of the queue, use after queue_peek_span
 
   @param queue - the queue to access
+  @param count - the number of elements to drop, clamped to the size of the queue
 */
-void* queue_pop( queue* queue );
+void queue_consume( queue* queue, u32 count );
 
 // Macros -----------------
-#define queue_create( type, capacity, tag ) _queue_create( sizeof( type ), capacity, tag )
+#define queue_create( type, capacity, tag ) _queue_create( sizeof( type ), capacity, tag, __FILE__, __LINE__ )
+#define queue_create_with_allocator( type, capacity, allocator ) _queue_create_with_allocator( sizeof( type ), capacity, allocator, __FILE__, __LINE__ )
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief A lock-free bounded FIFO for handing elements from exactly one producer thread to
+    exactly one consumer thread.  The producer and consumer indices live on separate cache lines,
+    each side publishes with a release store and reads the other side with an acquire load.  Only
+    the producer may push and only the consumer may pop
+*/
+typedef struct spsc_queue spsc_queue;
+
+/**
+  @brief Creates a new spsc queue, should only be used internally, Use spsc_queue_create instead
+
+  @param type_size - the size of each element
+  @param capacity - the max number of elements, rounded up to a power of two
+  @param memory_tag - the memory tag to be used for this allocation
+  @return Ptr - pointer to the new queue or 0 if unsuccessful
+*/
+FZY_API spsc_queue* _spsc_queue_create( u32 type_size, u32 capacity, u8 memory_tag );
+
+/**
+  @brief Frees the memory associated with the queue, neither thread may be using it
+
+  @param queue - the queue to destroy
+*/
+FZY_API void spsc_queue_destroy( spsc_queue* queue );
+
+/**
+  @brief Copies an element onto the back of the queue, producer thread only
+
+  @param queue - the queue to access
+  @param data - the element to add
+  @return b8 - false if the queue is full
+*/
+FZY_API b8 spsc_queue_push( spsc_queue* queue, const void* data );
+
+/**
+  @brief Copies as many of count contiguous elements as fit onto the back of the queue and
+    publishes them at once, producer thread only
+
+  @param queue - the queue to access
+  @param data - the first of the elements to add
+  @param count - the number of elements to add
+  @return u32 - the number of elements added
+*/
+FZY_API u32 spsc_queue_push_n( spsc_queue* queue, const void* data, u32 count );
+
+/**
+  @brief Copies the front element out of the queue and removes it, consumer thread only
+
+  @param queue - the queue to access
+  @param out - receives the element
+  @return b8 - false if the queue is empty
+*/
+FZY_API b8 spsc_queue_pop( spsc_queue* queue, void* out );
+
+/**
+  @brief Copies up to count elements out of the queue and releases their slots at once,
+    consumer thread only
+
+  @param queue - the queue to access
+  @param out - receives the elements, room for count elements
+  @param count - the most elements to pop
+  @return u32 - the number of elements popped
+*/
+FZY_API u32 spsc_queue_pop_n( spsc_queue* queue, void* out, u32 count );
+
+/**
+  @brief Returns the number of elements in the queue, only a snapshot when the other thread is active
+
+  @param queue - the queue to access
+  @return u32 - the number of elements
+*/
+FZY_API u32 spsc_queue_size( spsc_queue* queue );
+
+/**
+  @brief Returns the number of elements the queue can hold
+
+  @param queue - the queue to access
+  @return u32 - the capacity
+*/
+FZY_API u32 spsc_queue_capacity( spsc_queue* queue );
+
+// Macros -----------------
+#define spsc_queue_create( type, capacity, tag ) _spsc_queue_create( sizeof( type ), capacity, tag )
@@ -1,6 +1,32 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_mem.h"
+
+/*
+    @brief A non-owning run of characters, not necessarily null terminated.  Views point into
+        memory owned by someone else and are passed by value
+*/
+typedef struct string_view
+{
+    const char* data;
+    u64 length;
+
+} string_view;
+
+/*
+    @brief Builds a string in caller provided or stack storage without any heap allocation.
+        Every append checks the capacity, text that does not fit is cut off and truncated is
+        set.  data is always null terminated
+*/
+typedef struct string_builder
+{
+    char* data;
+    u64 capacity;   // bytes in data, including the null terminator
+    u64 length;
+    b8 truncated;
+
+} string_builder;
 
 /*
     @brief Gets the length of the given string
@@ -288,3 +314,166 @@ FZY_API void string_filename_from_path( char* dest, const char* path );
   @param path - The full path to extract from.
 */
 FZY_API void string_filename_no_extension_from_path( char* dest, const char* path );
+
+/*
+    @brief Makes a view of a null terminated string
+    @param str - The string to view, may be 0
+    @return string_view - A view of the whole string
+*/
+FZY_API string_view string_view_from( const char* str );
+
+/*
+    @brief Makes a view of length characters starting at data
+    @param data - The first character
+    @param length - The number of characters
+    @return string_view - The view
+*/
+FZY_API string_view string_view_create( const char* data, u64 length );
+
+/*
+    @brief Case-sensitive comparison of two views
+    @param a - the first view
+    @param b - the second view
+    @return b8 - true if the views hold the same characters
+*/
+FZY_API b8 string_view_is_equal( string_view a, string_view b );
+
+/*
+    @brief Case-sensitive comparison of a view with a null terminated string
+    @param view - the view to compare
+    @param str - the string to compare
+    @return b8 - true if the view holds exactly the characters of str
+*/
+FZY_API b8 string_view_is_equal_cstr( string_view view, const char* str );
+
+/*
+    @brief Gets a view of part of a view, start and length are clamped to the view
+    @param view - The view to take the part from
+    @param start - The index of the first character
+    @param length - The number of characters
+    @return string_view - The part of the view
+*/
+FZY_API string_view string_view_substring( string_view view, u64 start, u64 length );
+
+/*
+    @brief Gets a view without the whitespace at both ends, nothing is written
+    @param view - The view to trim
+    @return string_view - The trimmed view
+*/
+FZY_API string_view string_view_trim( string_view view );
+
+/*
+    @brief Returns the index of the first occurance of the character in the view, or -1 if not found
+    @param view - The view to search
+    @param c - The character to find
+    @return i64 - The index of the first occurance of c or -1
+*/
+FZY_API i64 string_view_index_of( string_view view, char c );
+
+/*
+    @brief Takes the text up to the next delimiter off the front of remaining.  Call in a loop
+        to walk the tokens of a view without copying them
+    @param remaining - The text left to split, advanced past the token and its delimiter
+    @param delimiter - The character separating tokens
+    @param out_token - Receives the token, which can be empty
+    @return b8 - false once remaining is empty
+*/
+FZY_API b8 string_view_split( string_view* remaining, char delimiter, string_view* out_token );
+
+/*
+    @brief Attempts to parse a 32-bit floating-point number from the view
+    @param view - The view to parse from, at most 63 characters are read
+    @param f - A pointer to the float to write to
+    @return b8 - true if parsed successfully; otherwise false
+*/
+FZY_API b8 string_view_to_f32( string_view view, f32* f );
+
+/*
+    @brief Attempts to parse a 32-bit signed integer from the view
+    @param view - The view to parse from, at most 63 characters are read
+    @param i - A pointer to the int to write to
+    @return b8 - true if parsed successfully; otherwise false
+*/
+FZY_API b8 string_view_to_i32( string_view view, i32* i );
+
+/*
+    @brief Starts a builder over caller provided storage, such as a stack array
+    @param buffer - The storage to build into
+    @param capacity - The size of buffer in bytes, including the null terminator
+    @return string_builder - An empty builder
+*/
+FZY_API string_builder string_builder_create( char* buffer, u64 capacity );
+
+/*
+    @brief Starts a builder over a block taken from the stack, the text lives until the stack is
+        freed past it
+    @param stack - The stack to take the storage from, usually memory_scratch_stack
+    @param capacity - The size of the block in bytes, including the null terminator
+    @return string_builder - An empty builder, with 0 capacity if the stack is full
+*/
+FZY_API string_builder string_builder_create_stack( memory_stack* stack, u64 capacity );
+
+/*
+    @brief Appends a null terminated string
+    @param builder - The builder to append to
+    @param str - The string to append
+    @return b8 - false if the text was cut off
+*/
+FZY_API b8 string_builder_append( string_builder* builder, const char* str );
+
+/*
+    @brief Appends the characters of a view
+    @param builder - The builder to append to
+    @param view - The view to append
+    @return b8 - false if the text was cut off
+*/
+FZY_API b8 string_builder_append_view( string_builder* builder, string_view view );
+
+/*
+    @brief Appends a character
+    @param builder - The builder to append to
+    @param c - The character to append
+    @return b8 - false if the character did not fit
+*/
+FZY_API b8 string_builder_append_char( string_builder* builder, char c );
+
+/*
+    @brief Appends an integer in decimal
+    @param builder - The builder to append to
+    @param i - The integer to append
+    @return b8 - false if the text was cut off
+*/
+FZY_API b8 string_builder_append_int( string_builder* builder, i64 i );
+
+/*
+    @brief Appends a float formatted with %f
+    @param builder - The builder to append to
+    @param f - The float to append
+    @return b8 - false if the text was cut off
+*/
+FZY_API b8 string_builder_append_float( string_builder* builder, f32 f );
+
+/*
+    @brief Appends formatted text, formatting straight into the builder's storage
+    @param builder - The builder to append to
+    @param format - The format string
+    @param ... - the format arguements
+    @return b8 - false if the text was cut off
+*/
+FZY_API b8 string_builder_append_format( string_builder* builder, const char* format, ... );
+
+/*
+    @brief Gets a view of the text built so far
+    @param builder - The builder to view
+    @return string_view - A view of the text
+*/
+FZY_API string_view string_builder_view( string_builder* builder );
+
+/*
+    @brief Empties the builder so its storage can be reused
+    @param builder - The builder to empty
+*/
+FZY_API void string_builder_reset( string_builder* builder );
+
+// Macros -----------------
+#define string_view_literal( literal ) string_view_create( "" literal, sizeof( "" literal ) - 1 )
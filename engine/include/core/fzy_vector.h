@@ -2,17 +2,71 @@
 
 
 #include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_logger.h"
+
+/* @brief Every vector keeps room for at least this many bytes of elements in the block holding its
+    header, so small vectors never make a second allocation.  With the 80 byte header the smallest
+    vector fills a 144 byte block */
+#ifndef FZY_VECTOR_INLINE_BYTES
+#define FZY_VECTOR_INLINE_BYTES 64
+#endif
+
+/* @brief Represents a vector in the engine. Holds what memory type it belongs to.  The fields are
+    public for the typed vector functions generated by FZY_VECTOR_DECLARE, use the functions */
+typedef struct vector_t
+{
+  u64 size;             // The size of each element in the array
+  u32 capacity;         // The capacity of the array
+  u32 count;            // The number of elements in the array
+  u32 inline_capacity;  // The number of elements that fit in the block holding the header
+  u16 memory_tag;       // The memeory group the vector belongs to
+  b8 reserved;          // The data array lives in a virtual arena that follows the header
+  memory_allocator allocator;   // Source of the header block and the data array
+  void *data;           // The data array, follows the header until the vector outgrows it
+  const char *file;     // The call site that created the vector, its data arrays are charged to it
+  u32 line;
+
+} vector;
 
-typedef struct vector_t vector;
+/*
+  @brief Creates a new vector with the appropiate memory tag.  Should only be used internally, Use
+    vector_create instead
+
+  @param element_size The size of each element in the vector
+  @param capacity The capacity of the vector on creation, raised to fill FZY_VECTOR_INLINE_BYTES
+  @param file The source file creating the vector, supplied by the vector_create macro
+  @param line The source line creating the vector, supplied by the vector_create macro
+  @return Pointer - Points to the created vector
+*/
+FZY_API vector *_vector_create( u64 element_size, u32 capacity, u16 memory_tag, const char *file, u32 line );
 
 /*
-  @brief Creates a new vector with the appropiate memory tag
+  @brief Creates a new vector whose header and data array come from the given allocator, so the
+    vector can live in the frame arena, on a stack or in a fixed buffer
 
   @param element_size The size of each element in the vector
   @param capacity The capacity of the vector on creation
-  @return Pointer - Points to the created vector
+  @param allocator The allocator for the vector's memory, copied into the vector
+  @param file The source file creating the vector, supplied by the vector_create_with_allocator macro
+  @param line The source line creating the vector, supplied by the vector_create_with_allocator macro
+  @return Pointer - Points to the created vector or 0 if the allocator failed
+*/
+FZY_API vector *_vector_create_with_allocator( u64 element_size, u32 capacity, const memory_allocator* allocator,
+                                               const char *file, u32 line );
+
+/*
+  @brief Creates a vector whose data lives in reserved address space.  The vector grows in place up
+    to max_capacity elements, so pointers to its elements stay valid and only the pages that are
+    touched are committed
+
+  @param element_size The size of each element in the vector
+  @param max_capacity The most elements the vector can ever hold
+  @param file The source file creating the vector, supplied by the vector_create_reserved macro
+  @param line The source line creating the vector, supplied by the vector_create_reserved macro
+  @return Pointer - Points to the created vector or 0 if the address space could not be reserved
 */
-FZY_API vector *vector_create( u64 element_size, u32 capacity, u16 memory_tag );
+FZY_API vector *_vector_create_reserved( u64 element_size, u32 max_capacity, u16 memory_tag, const char *file, u32 line );
 
 /*
   @brief Frees all memory held by the vector
@@ -61,6 +115,74 @@ FZY_API void vector_remove( vector *vector, void *element );
 */
 FZY_API void vector_remove_index( vector *vector, u32 index );
 
+/*
+  @brief Find and remove the element by moving the last element into its slot, does not keep the
+    order of the elements
+
+  @param vector The vector to access
+  @param element The element to remove
+*/
+FZY_API void vector_remove_swap( vector *vector, void *element );
+
+/*
+  @brief Remove the element at the given index by moving the last element into its slot, does
+    not keep the order of the elements
+
+  @param vector The vector to access
+  @param index The index to remove the element from
+*/
+FZY_API void vector_remove_index_swap( vector *vector, u32 index );
+
+/*
+  @brief Removes every element the predicate returns true for in a single pass, the order of
+    the remaining elements is kept
+
+  @param vector The vector to access
+  @param predicate Returns true for elements to remove
+  @param user_data Passed to every call of the predicate
+  @return The number of elements removed
+*/
+FZY_API u32 vector_remove_if( vector *vector, b8 (*predicate)( void* element, void* user_data ), void* user_data );
+
+/*
+  @brief Grows the data array to hold at least capacity elements without changing the count
+
+  @param vector The vector to access
+  @param capacity The number of elements to make room for
+  @return b8 - true if the vector can hold capacity elements
+*/
+FZY_API b8 vector_reserve( vector *vector, u32 capacity );
+
+/*
+  @brief Sets the number of elements in the vector, new elements are zeroed
+
+  @param vector The vector to access
+  @param count The new number of elements
+  @return b8 - true if successful
+*/
+FZY_API b8 vector_resize( vector *vector, u32 count );
+
+/*
+  @brief Inserts count elements before index, growing the vector at most once
+
+  @param vector The vector to access
+  @param index The index to insert at, up to the vector size
+  @param data The elements to copy in
+  @param count The number of elements in data
+  @return b8 - true if successful
+*/
+FZY_API b8 vector_insert_range( vector *vector, u32 index, const void *data, u32 count );
+
+/*
+  @brief Appends count elements to the back of the vector, growing the vector at most once
+
+  @param vector The vector to access
+  @param data The elements to copy in
+  @param count The number of elements in data
+  @return b8 - true if successful
+*/
+FZY_API b8 vector_append_range( vector *vector, const void *data, u32 count );
+
 /*
   @brief Returns the number of elements in the vector
 
@@ -117,6 +239,11 @@ FZY_API u32 vector_stride( vector* vector );
 FZY_API void* _vector_data( vector* vector );
 
 
+/** @brief Creation, capturing the call site for the allocation tracker ------- */
+#define vector_create( element_size, capacity, memory_tag ) _vector_create( element_size, capacity, memory_tag, __FILE__, __LINE__ )
+#define vector_create_with_allocator( element_size, capacity, allocator ) _vector_create_with_allocator( element_size, capacity, allocator, __FILE__, __LINE__ )
+#define vector_create_reserved( element_size, max_capacity, memory_tag ) _vector_create_reserved( element_size, max_capacity, memory_tag, __FILE__, __LINE__ )
+
 /** @brief Iterator Access ---------------------------------------------------- */
 #define vector_begin( vector_ptr ) ((u8*)_vector_data(vector_ptr) )
 #define vector_end( vector_ptr ) ((u8*)_vector_data(vector_ptr) + fzy_vector_size(vector_ptr) * fzy_vector_stride(vector_ptr) )
@@ -124,3 +251,58 @@ FZY_API void* _vector_data( vector* vector );
 
 #define vector_for_each( type, item_ptr, vector_ptr ) \
   for( u8* __it = vector_begin( vector_ptr ); __it < vector_end(vector_ptr) ** ((item_ptr) = (type*)__it); __it += vector_stride( vector_ptr ) )
+
+/*
+  @brief Declares a vector of the given type, type must be a single identifier ( use a typedef for
+    pointers and structs ).  The typed vector is a vector, it can be passed to every vector
+    function, and adds inline functions that load and store the element type directly:
+
+    vector_type* vector_type_create( u32 capacity, u16 memory_tag )
+    void vector_type_push( vector_type* vector, type value )
+    type vector_type_pop( vector_type* vector )
+    type* vector_type_get( vector_type* vector, u32 index )
+    type* vector_type_data( vector_type* vector )
+
+    The allocation tracker charges typed vectors to this header rather than the caller
+*/
+#define FZY_VECTOR_DECLARE( type )                                                        \
+  typedef vector vector_##type;                                                           \
+                                                                                          \
+  FZY_INLINE vector_##type* vector_##type##_create( u32 capacity, u16 memory_tag )        \
+  {                                                                                       \
+    return vector_create( sizeof( type ), capacity, memory_tag );                         \
+  }                                                                                       \
+                                                                                          \
+  FZY_INLINE void vector_##type##_push( vector_##type* vector, type value )               \
+  {                                                                                       \
+    if( vector->count == vector->capacity &&                                              \
+        !vector_reserve( vector, vector->capacity ? vector->capacity * 2 : 4 ) )          \
+    {                                                                                     \
+      FZY_ERROR( "vector_" #type "_push :: failed to reallocate data array." );           \
+    }                                                                                     \
+    ( (type*)vector->data )[ vector->count++ ] = value;                                   \
+  }                                                                                       \
+                                                                                          \
+  FZY_INLINE type vector_##type##_pop( vector_##type* vector )                            \
+  {                                                                                       \
+    FZY_VECTOR_CHECK( vector->count > 0, "vector_" #type "_pop :: vector is empty." );    \
+    return ( (type*)vector->data )[ --vector->count ];                                    \
+  }                                                                                       \
+                                                                                          \
+  FZY_INLINE type* vector_##type##_get( vector_##type* vector, u32 index )                \
+  {                                                                                       \
+    FZY_VECTOR_CHECK( index < vector->count, "vector_" #type "_get :: index out of range." ); \
+    return (type*)vector->data + index;                                                   \
+  }                                                                                       \
+                                                                                          \
+  FZY_INLINE type* vector_##type##_data( vector_##type* vector )                          \
+  {                                                                                       \
+    return (type*)vector->data;                                                           \
+  }
+
+// bounds checks for the typed vectors, compiled out of release builds
+#ifdef FZY_CONFIG_DEBUG
+  #define FZY_VECTOR_CHECK( condition, message ) if( !( condition ) ) FZY_ERROR( message )
+#else
+  #define FZY_VECTOR_CHECK( condition, message )
+#endif
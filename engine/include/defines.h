@@ -106,6 +106,14 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.");
 
 #endif
 
+#if defined(_MSC_VER)
+  /** @brief Thread local storage qualifier */
+  #define FZY_THREAD_LOCAL __declspec(thread)
+#else
+  /** @brief Thread local storage qualifier */
+  #define FZY_THREAD_LOCAL __thread
+#endif
+
 #define MAX_NAME_LENGTH 128
 
 /*
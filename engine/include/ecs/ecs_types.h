@@ -2,6 +2,7 @@
 
 #include "defines.h"
 #include "core/fzy_vector.h"
+#include "core/fzy_mem.h"
 
 #define MAX_ENTITIES 12288
 #define MAX_COMPONENTS 64
@@ -10,6 +11,9 @@
 /** @brief Struct to hold an entity */
 typedef u16 entity;
 
+/** @brief Typed vector of entities, vector_entity_push / vector_entity_get work on entity values directly */
+FZY_VECTOR_DECLARE( entity )
+
 typedef u8 component_type_id;
 typedef u8 process_type_id;
 
@@ -33,6 +37,7 @@ typedef u64 signature;
 typedef struct component_array
 {
   void *components;            // pointer to memory holding the components
+  virtual_arena storage;       // reserves room for every entity, pages are committed as components are added
   u32 type_size;               // size of each component
 
   i32 index_to_entity[ MAX_ENTITIES ];  // maps the array index to an entity
@@ -45,8 +50,9 @@ typedef struct component_array
 // structure to represent a system that operates on components
 typedef struct process
 {
-  vector* entities;      // entities the system interacts with
+  vector_entity* entities;   // entities the system interacts with
   signature signature;   // the system signature
+  i32 entity_to_index[ MAX_ENTITIES ];   // maps an entity to its index in entities, -1 when absent
 
   void (*update_fn)( vector* entities, f32 delta );   // function to update the system
 
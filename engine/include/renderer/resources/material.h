@@ -50,3 +50,11 @@ void material_remove( const char* name );
   @return ptr - Pointer to the resource
 */
 material* material_get( const char* name );
+
+/**
+  @brief Gets a reference to the material with the name id
+
+  @param name - the name_id of the material's name
+  @return ptr - Pointer to the resource
+*/
+material* material_get_id( name_id name );
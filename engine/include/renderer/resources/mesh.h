@@ -96,6 +96,13 @@ FZY_API void mesh_remove( const char* name );
 */
 FZY_API mesh* mesh_get( const char* name );
 
+/**
+  @brief Gets a reference to a mesh by the id of its name
+
+  @param name - the name_id of the mesh's name
+*/
+FZY_API mesh* mesh_get_id( name_id name );
+
 /**
   @brief Sets the vertices for this mesh, this will replace all vertices in the mesh
 
@@ -105,6 +112,18 @@ FZY_API mesh* mesh_get( const char* name );
 */
 FZY_API void mesh_set_vertices( mesh* mesh, vector* vertices, vector* indices );
 
+/**
+  @brief Sets the vertices for this mesh from plain arrays, this will replace all vertices in the
+    mesh.  The arrays are copied, so they can be built on a scratch stack and freed afterwards
+
+  @param mesh - the mesh to set the vertices for
+  @param vertices - the array of vertices, each the mesh's vertex stride in size
+  @param vertex_count - the number of vertices in the array
+  @param indices - the array of indices indicating how to draw the vertices
+  @param index_count - the number of indices in the array
+*/
+FZY_API void mesh_set_vertex_data( mesh* mesh, const void* vertices, u32 vertex_count, const u32* indices, u32 index_count );
+
 /**
   @brief adds the vertices to the mesh
 
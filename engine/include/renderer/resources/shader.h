@@ -1,6 +1,7 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_name.h"
 
 //-----------------------------------------------------------------------------
 // Structs
@@ -67,6 +68,14 @@ FZY_API void shader_remove( const char* name );
 */
 FZY_API shader* shader_get( const char* name );
 
+/**
+  @brief Retrieves a shader by the id of its name and adds a reference to it
+
+  @param name - The name_id of the shader's name
+  @return pointer - pointer to the shader or NULL if not found
+*/
+FZY_API shader* shader_get_id( name_id name );
+
 /**
   @brief Add a uniform to the uniforms table in the shader
 
@@ -86,6 +95,16 @@ FZY_API b8 shader_add_uniform( shader* sdr, const char* uniform_name, u8 type );
 */
 FZY_API void shader_set_uniform( shader* sdr, const char* uniform_name, void* value );
 
+/**
+  @brief Sets the value of the uniform with the given name id, per frame code should prefer
+    this with FZY_NAME so the uniform name is never hashed at runtime
+
+  @param sdr The shader to access
+  @param name The name_id of the uniform's name
+  @param value Pointer to the value to copy to the uniform
+*/
+FZY_API void shader_set_uniform_id( shader* sdr, name_id uniform_name, void* value );
+
 /**
   @brief Tells the backend to bind this shader
 
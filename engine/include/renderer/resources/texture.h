@@ -1,6 +1,7 @@
 #pragma once
 
 #include "defines.h"
+#include "core/fzy_name.h"
 
 //----------------------------------------------------------------------------------
 // structs
@@ -67,6 +68,14 @@ void texture_destroy_writeable( texture* tex );
 */
 void texture_remove( const char* name );
 
+/**
+  @brief Gets a reference to a texture previously added with texture_add
+
+  @param name - the name_id of the texture's name
+  @return ptr - Pointer to the texture or NULL if not found
+*/
+texture* texture_get_id( name_id name );
+
 /**
   @brief Binds the texture for rendering
 
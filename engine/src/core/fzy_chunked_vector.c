@@ -0,0 +1,163 @@
+#include "core/fzy_chunked_vector.h"
+
+#include "core/fzy_mem.h"
+#include "core/fzy_logger.h"
+
+/* @brief Represents a chunked vector, the chunk table is the only block that is ever reallocated */
+typedef struct chunked_vector
+{
+  u8 **chunks;                  // table of chunk pointers, chunks are never moved
+  u64 size;                     // The size of each element
+  u32 chunk_shift;              // log2 of the elements per chunk
+  u32 chunk_mask;               // elements per chunk - 1
+  u32 count;                    // The number of elements in the vector
+  u32 chunk_count;              // The number of allocated chunks
+  u32 table_capacity;           // The number of slots in the chunk table
+  memory_allocator allocator;   // Source of the header, the chunk table and the chunks
+  const char *file;             // call site that created the vector, its chunks are charged to it
+  u32 line;
+
+} chunked_vector;
+
+// returns the address of the element at index, the index must have a chunk
+static inline void *chunked_offset( chunked_vector *vector, u32 index )
+{
+  return vector->chunks[ index >> vector->chunk_shift ] + (u64)( index & vector->chunk_mask ) * vector->size;
+} // ---------------------------------------------------------------------------
+
+static inline u64 chunk_bytes( chunked_vector *vector )
+{
+  return vector->size << vector->chunk_shift;
+} // ---------------------------------------------------------------------------
+
+// adds one chunk, only the table of chunk pointers can move
+static b8 chunked_vector_grow( chunked_vector *vector )
+{
+  if( vector->chunk_count == vector->table_capacity )
+  {
+    u32 capacity = vector->table_capacity ? vector->table_capacity * 2 : 4;
+    u8 **chunks = vector->allocator.reallocate( vector->allocator.context, vector->chunks,
+                                                sizeof( u8* ) * vector->table_capacity,
+                                                sizeof( u8* ) * capacity,
+                                                vector->file, vector->line );
+    if( !chunks ) return false;
+    vector->chunks = chunks;
+    vector->table_capacity = capacity;
+  }
+
+  u8 *chunk = vector->allocator.allocate( vector->allocator.context, chunk_bytes( vector ), vector->file, vector->line );
+  if( !chunk ) return false;
+
+  vector->chunks[ vector->chunk_count++ ] = chunk;
+  return true;
+} // ---------------------------------------------------------------------------
+
+chunked_vector *_chunked_vector_create( u64 element_size, u32 elements_per_chunk, u16 memory_tag, const char *file, u32 line )
+{
+  memory_allocator allocator = memory_allocator_heap( memory_tag );
+  return _chunked_vector_create_with_allocator( element_size, elements_per_chunk, &allocator, file, line );
+} // ---------------------------------------------------------------------------
+
+chunked_vector *_chunked_vector_create_with_allocator( u64 element_size, u32 elements_per_chunk, const memory_allocator* allocator,
+                                                       const char *file, u32 line )
+{
+  chunked_vector *v = allocator->allocate( allocator->context, sizeof( struct chunked_vector ), file, line );
+  if( !v ) return 0;
+
+  // a power of two lets an index be split with a shift and a mask
+  u32 shift = 0;
+  while( ( 1u << shift ) < elements_per_chunk && shift < 31 ) shift++;
+
+  v->chunks = 0;
+  v->size = element_size;
+  v->chunk_shift = shift;
+  v->chunk_mask = ( 1u << shift ) - 1;
+  v->count = 0;
+  v->chunk_count = 0;
+  v->table_capacity = 0;
+  v->allocator = *allocator;
+  v->file = file;
+  v->line = line;
+  return v;
+} // ---------------------------------------------------------------------------
+
+void chunked_vector_destroy( chunked_vector *vector )
+{
+  if( !vector ) return;
+
+  memory_allocator allocator = vector->allocator;
+  for( u32 i = 0; i < vector->chunk_count; i++ )
+    allocator.free( allocator.context, vector->chunks[ i ], chunk_bytes( vector ) );
+
+  if( vector->chunks )
+    allocator.free( allocator.context, vector->chunks, sizeof( u8* ) * vector->table_capacity );
+  allocator.free( allocator.context, vector, sizeof( struct chunked_vector ) );
+} // ---------------------------------------------------------------------------
+
+void *chunked_vector_push( chunked_vector *vector, const void *element )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "chunked_vector_push :: vector is null." );
+  #endif
+
+  if( ( vector->count >> vector->chunk_shift ) == vector->chunk_count && !chunked_vector_grow( vector ) )
+  {
+    FZY_ERROR( "chunked_vector_push :: failed to allocate a chunk." );
+    return 0;
+  }
+
+  void *pos = chunked_offset( vector, vector->count );
+  if( element ) memory_copy( pos, element, vector->size );
+  else memory_zero( pos, vector->size );
+  vector->count++;
+  return pos;
+} // ---------------------------------------------------------------------------
+
+void chunked_vector_pop( chunked_vector *vector )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "chunked_vector_pop :: vector is null." );
+  #endif
+
+  if( vector->count > 0 ) vector->count--;
+} // ---------------------------------------------------------------------------
+
+void chunked_vector_remove_index_swap( chunked_vector *vector, u32 index )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "chunked_vector_remove_index_swap :: vector is null." );
+  #endif
+
+  if( index < vector->count )
+  {
+    vector->count--;
+    if( index != vector->count )
+      memory_copy( chunked_offset( vector, index ), chunked_offset( vector, vector->count ), vector->size );
+  }
+} // ---------------------------------------------------------------------------
+
+void *_chunked_vector_get( chunked_vector *vector, u32 index )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "_chunked_vector_get :: vector is null." );
+  #endif
+
+  if( index < vector->count )
+    return chunked_offset( vector, index );
+  return 0;
+} // ---------------------------------------------------------------------------
+
+u32 chunked_vector_size( chunked_vector *vector )
+{
+  return vector->count;
+} // ---------------------------------------------------------------------------
+
+u32 chunked_vector_capacity( chunked_vector *vector )
+{
+  return vector->chunk_count << vector->chunk_shift;
+} // ---------------------------------------------------------------------------
+
+void chunked_vector_clear( chunked_vector *vector )
+{
+  vector->count = 0;
+} // ---------------------------------------------------------------------------
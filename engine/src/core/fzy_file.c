@@ -10,7 +10,8 @@
 static const u32 default_buffer = 1024;
 
 
-b8 file_read( const char* path, file_handle* out_handle )
+// reads the file into the stack when given one, otherwise into a heap block
+static b8 read_file( const char* path, memory_stack* stack, file_handle* out_handle )
 {
   if( !out_handle ) return false;
 
@@ -27,20 +28,50 @@ b8 file_read( const char* path, file_handle* out_handle )
   out_handle->size = ftell( f ) + 1;
   fseek( f, 0, SEEK_SET );
 
-  out_handle->data = memory_allocate( out_handle->size, MEM_TAG_FILE );
+  if( stack )
+    out_handle->data = memory_stack_allocate( stack, out_handle->size );
+  else
+    out_handle->data = memory_allocate_uninitialized( out_handle->size, MEM_TAG_FILE );
+
+  if( !out_handle->data )
+  {
+    out_handle->size = 0;
+    fclose( f );
+    return false;
+  }
 
   fread( out_handle->data, 1, out_handle->size - 1, f );
   out_handle->pos = 0;
+  out_handle->stack = stack;
   out_handle->data[ out_handle->size - 1 ] = '\0';
   fclose( f );
   return true;
 } // ---------------------------------------------------------------------------
 
+// bytes of file contents in a handle that was read, size counts the '\0' added after them
+static inline u64 content_size( const file_handle* handle )
+{
+  return handle->size ? handle->size - 1 : 0;
+} // ---------------------------------------------------------------------------
+
+b8 file_read( const char* path, file_handle* out_handle )
+{
+  return read_file( path, 0, out_handle );
+} // ---------------------------------------------------------------------------
+
+b8 file_read_stack( const char* path, memory_stack* stack, file_handle* out_handle )
+{
+  if( !stack ) return false;
+  return read_file( path, stack, out_handle );
+} // ---------------------------------------------------------------------------
+
 void file_close( file_handle *handle )
 {
   if( !handle || !handle->data ) return;
 
-  memory_delete( handle->data, handle->size, MEM_TAG_FILE );
+  // stack data is released when the stack is freed to a marker below it
+  if( !handle->stack ) memory_delete( handle->data, handle->size, MEM_TAG_FILE );
+  handle->stack = 0;
   handle->pos = 0;
   handle->size = 0;
   handle->data = 0;
@@ -50,27 +81,50 @@ b8 file_read_bytes( file_handle *handle, u64 size_to_read, void* data )
 {
   if( !handle || !handle->data ) return false;
 
-  if( ( handle->pos + size_to_read ) > handle->size ) return false;
+  if( ( handle->pos + size_to_read ) > content_size( handle ) ) return false;
 
   memory_copy( data, &handle->data[handle->pos], size_to_read );
   handle->pos += size_to_read;
   return true;
 } // ---------------------------------------------------------------------------
 
+string_view file_get_view( file_handle *handle )
+{
+  if( !handle || !handle->data ) return string_view_create( 0, 0 );
+  return string_view_create( (const char*)handle->data, content_size( handle ) );
+} // ---------------------------------------------------------------------------
+
+b8 file_read_line( file_handle *handle, string_view* out_line )
+{
+  if( !handle || !handle->data ) return false;
+
+  u64 size = content_size( handle );
+  if( handle->pos >= size ) return false;
+
+  string_view remaining = string_view_create( (const char*)handle->data + handle->pos, size - handle->pos );
+  string_view_split( &remaining, '\n', out_line );
+  handle->pos = size - remaining.length;
+
+  if( out_line->length && out_line->data[ out_line->length - 1 ] == '\r' ) out_line->length--;
+  return true;
+} // ---------------------------------------------------------------------------
+
 void file_add_data( file_handle* handle, const void* data, u64 data_size )
 {
   if( handle->data == 0 )
   {
-    handle->data = memory_allocate( default_buffer, MEM_TAG_FILE );
+    handle->data = memory_allocate_uninitialized( default_buffer, MEM_TAG_FILE );
     handle->pos = 0;
     handle->size = default_buffer;
+    handle->stack = 0;
   }
   if( handle->pos + data_size >= handle->size )
   {
     u64 ns = handle->size + data_size + default_buffer;
-    u8* tmp = memory_allocate( ns, MEM_TAG_FILE );
+    u8* tmp = memory_allocate_uninitialized( ns, MEM_TAG_FILE );
     memory_copy( tmp, handle->data, handle->pos );
-    memory_delete( handle->data, handle->size, MEM_TAG_FILE );
+    if( !handle->stack ) memory_delete( handle->data, handle->size, MEM_TAG_FILE );
+    handle->stack = 0;
     handle->data = tmp;
     handle->size = ns;
   }
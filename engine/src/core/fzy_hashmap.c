@@ -0,0 +1,264 @@
+#include "core/fzy_hashmap.h"
+
+#include "core/fzy_mem.h"
+#include "core/fzy_logger.h"
+
+/*
+  @brief Represents a hashmap.  Keys, probe distances and values live in parallel arrays so a
+    probe only walks the distances and keys, the values are touched once the key is found
+*/
+typedef struct hashmap
+{
+  u64* keys;
+  u32* distances;               // 0 when empty, otherwise the probe length from the home slot + 1
+  u8* values;                   // capacity * value_size bytes
+  u8* carry;                    // two values of scratch used to swap entries while inserting
+  u64 value_size;
+  u32 capacity;                 // always a power of two
+  u32 mask;                     // capacity - 1
+  u32 count;
+  memory_allocator allocator;   // Source of the map and its arrays
+  const char* file;             // call site that created the map, its arrays are charged to it
+  u32 line;
+
+} hashmap;
+
+// smallest slot array
+#define MIN_CAPACITY 8
+// ---------------------------------------------------------------------------
+
+// integer keys are often sequential, mix every bit into the low ones used for the slot index
+static inline u64 hash_u64( u64 key )
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+} // ---------------------------------------------------------------------------
+
+static inline u8 *value_at( hashmap *map, u32 index )
+{
+  return map->values + (u64)index * map->value_size;
+} // ---------------------------------------------------------------------------
+
+static inline u64 array_bytes( hashmap *map, u32 capacity )
+{
+  return ( sizeof( u64 ) + sizeof( u32 ) + map->value_size ) * capacity;
+} // ---------------------------------------------------------------------------
+
+// returns the slot holding the key or -1
+static i64 hashmap_find( hashmap *map, u64 key )
+{
+  u32 index = (u32)hash_u64( key ) & map->mask;
+
+  for( u32 distance = 1; ; distance++ )
+  {
+    u32 d = map->distances[ index ];
+    if( d < distance ) return -1;
+    if( map->keys[ index ] == key ) return index;
+    index = ( index + 1 ) & map->mask;
+  }
+} // ---------------------------------------------------------------------------
+
+// places a key that is not in the map, the value is read from carry, returns the key's slot
+static u32 hashmap_place( hashmap *map, u64 key )
+{
+  u8 *carried = map->carry;
+  u8 *spare = map->carry + map->value_size;
+  u32 distance = 1;
+  u32 index = (u32)hash_u64( key ) & map->mask;
+  u32 result = (u32)-1;
+
+  for( ;; )
+  {
+    if( map->distances[ index ] == 0 )
+    {
+      map->keys[ index ] = key;
+      map->distances[ index ] = distance;
+      memory_copy( value_at( map, index ), carried, map->value_size );
+      return result == (u32)-1 ? index : result;
+    }
+
+    // take from the rich, the displaced entry carries on probing
+    if( map->distances[ index ] < distance )
+    {
+      u64 k = map->keys[ index ];
+      u32 d = map->distances[ index ];
+      memory_copy( spare, value_at( map, index ), map->value_size );
+
+      map->keys[ index ] = key;
+      map->distances[ index ] = distance;
+      memory_copy( value_at( map, index ), carried, map->value_size );
+      if( result == (u32)-1 ) result = index;
+
+      key = k;
+      distance = d;
+      u8 *tmp = carried;
+      carried = spare;
+      spare = tmp;
+    }
+
+    distance++;
+    index = ( index + 1 ) & map->mask;
+  }
+} // ---------------------------------------------------------------------------
+
+static b8 hashmap_resize( hashmap *map, u32 capacity )
+{
+  u8 *block = map->allocator.allocate( map->allocator.context, array_bytes( map, capacity ), map->file, map->line );
+  if( !block ) return false;
+
+  u64 *old_keys = map->keys;
+  u32 *old_distances = map->distances;
+  u8 *old_values = map->values;
+  u32 old_capacity = map->capacity;
+
+  // one block: keys, then distances, then values.  capacity is at least 8 so the values start 8 byte aligned
+  map->keys = (u64*)block;
+  map->distances = (u32*)( block + sizeof( u64 ) * capacity );
+  map->values = block + ( sizeof( u64 ) + sizeof( u32 ) ) * capacity;
+  map->capacity = capacity;
+  map->mask = capacity - 1;
+  memory_zero( map->distances, sizeof( u32 ) * capacity );
+
+  for( u32 i = 0; i < old_capacity; i++ )
+  {
+    if( !old_distances[ i ] ) continue;
+    memory_copy( map->carry, old_values + (u64)i * map->value_size, map->value_size );
+    hashmap_place( map, old_keys[ i ] );
+  }
+
+  if( old_keys ) map->allocator.free( map->allocator.context, old_keys, array_bytes( map, old_capacity ) );
+  return true;
+} // ---------------------------------------------------------------------------
+
+hashmap *_hashmap_create( u64 value_size, u32 capacity, u16 memory_tag, const char *file, u32 line )
+{
+  memory_allocator allocator = memory_allocator_heap( memory_tag );
+  return _hashmap_create_with_allocator( value_size, capacity, &allocator, file, line );
+} // ---------------------------------------------------------------------------
+
+hashmap *_hashmap_create_with_allocator( u64 value_size, u32 capacity, const memory_allocator* allocator,
+                                         const char *file, u32 line )
+{
+  hashmap *map = allocator->allocate( allocator->context, sizeof( struct hashmap ), file, line );
+  if( !map ) return 0;
+
+  map->keys = 0;
+  map->distances = 0;
+  map->values = 0;
+  map->value_size = value_size;
+  map->capacity = 0;
+  map->mask = 0;
+  map->count = 0;
+  map->allocator = *allocator;
+  map->file = file;
+  map->line = line;
+  map->carry = allocator->allocate( allocator->context, value_size * 2, file, line );
+
+  // room for capacity entries below the 7/8 load factor
+  u32 slots = MIN_CAPACITY;
+  while( (u64)slots * 7 < (u64)capacity * 8 && slots < 0x80000000u ) slots <<= 1;
+
+  if( !map->carry || !hashmap_resize( map, slots ) )
+  {
+    if( map->carry ) allocator->free( allocator->context, map->carry, value_size * 2 );
+    allocator->free( allocator->context, map, sizeof( struct hashmap ) );
+    return 0;
+  }
+  return map;
+} // ---------------------------------------------------------------------------
+
+void hashmap_destroy( hashmap *map )
+{
+  if( !map ) return;
+
+  memory_allocator allocator = map->allocator;
+  allocator.free( allocator.context, map->keys, array_bytes( map, map->capacity ) );
+  allocator.free( allocator.context, map->carry, map->value_size * 2 );
+  allocator.free( allocator.context, map, sizeof( struct hashmap ) );
+} // ---------------------------------------------------------------------------
+
+void *hashmap_insert( hashmap *map, u64 key, const void *value )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( map == 0 ) FZY_ERROR( "hashmap_insert :: map is null." );
+  #endif
+
+  i64 found = hashmap_find( map, key );
+  if( found >= 0 )
+  {
+    u8 *pos = value_at( map, (u32)found );
+    if( value ) memory_copy( pos, value, map->value_size );
+    else memory_zero( pos, map->value_size );
+    return pos;
+  }
+
+  // grow once the map is 7/8 full
+  if( (u64)( map->count + 1 ) * 8 > (u64)map->capacity * 7 && !hashmap_resize( map, map->capacity * 2 ) )
+  {
+    FZY_ERROR( "hashmap_insert :: failed to grow the map." );
+    return 0;
+  }
+
+  if( value ) memory_copy( map->carry, value, map->value_size );
+  else memory_zero( map->carry, map->value_size );
+
+  map->count++;
+  return value_at( map, hashmap_place( map, key ) );
+} // ---------------------------------------------------------------------------
+
+void *_hashmap_get( hashmap *map, u64 key )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( map == 0 ) FZY_ERROR( "_hashmap_get :: map is null." );
+  #endif
+
+  i64 found = hashmap_find( map, key );
+  return found >= 0 ? value_at( map, (u32)found ) : 0;
+} // ---------------------------------------------------------------------------
+
+b8 hashmap_contains( hashmap *map, u64 key )
+{
+  return hashmap_find( map, key ) >= 0;
+} // ---------------------------------------------------------------------------
+
+b8 hashmap_remove( hashmap *map, u64 key, void *out_value )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( map == 0 ) FZY_ERROR( "hashmap_remove :: map is null." );
+  #endif
+
+  i64 found = hashmap_find( map, key );
+  if( found < 0 ) return false;
+
+  u32 hole = (u32)found;
+  if( out_value ) memory_copy( out_value, value_at( map, hole ), map->value_size );
+  map->count--;
+
+  // shift the following run back by one instead of leaving a tombstone
+  u32 next = ( hole + 1 ) & map->mask;
+  while( map->distances[ next ] > 1 )
+  {
+    map->keys[ hole ] = map->keys[ next ];
+    map->distances[ hole ] = map->distances[ next ] - 1;
+    memory_copy( value_at( map, hole ), value_at( map, next ), map->value_size );
+    hole = next;
+    next = ( next + 1 ) & map->mask;
+  }
+  map->distances[ hole ] = 0;
+  return true;
+} // ---------------------------------------------------------------------------
+
+u32 hashmap_count( hashmap *map )
+{
+  return map->count;
+} // ---------------------------------------------------------------------------
+
+void hashmap_clear( hashmap *map )
+{
+  memory_zero( map->distances, sizeof( u32 ) * map->capacity );
+  map->count = 0;
+} // ---------------------------------------------------------------------------
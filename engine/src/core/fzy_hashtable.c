@@ -2,58 +2,262 @@
 #include "core/fzy_logger.h"
 #include "core/fzy_string.h"
 #include "core/fzy_mem.h"
+#include "core/fzy_name.h"
 
-#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #define FZY_HASHTABLE_SSE2
+  #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
 
 
 //---------------------------------------------------------------------------------
 // static Functions
 // --------------------------------------------------------------------------------
 
-static inline u64 fnv1a_hash64( const char *key )
+// index of the lowest set bit, mask must not be 0
+static inline u32 lowest_bit( u32 mask )
 {
-  u64 hash = 1469598103934665603ULL; // offset basis
-  while( *key )
-  {
-    hash ^= (uint8_t)(*key++);
-    hash *= 1099511628211ULL; // FNV prime
-  }
-  return hash;
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward( &index, mask );
+  return (u32)index;
+#else
+  return (u32)__builtin_ctz( mask );
+#endif
+} // --------------------------------------------------------------------------
+
+// bit i is set when tags[ i ] == tag, for the 16 tags of a group
+static inline u32 group_match( const u8* tags, u8 tag )
+{
+#if defined(FZY_HASHTABLE_SSE2)
+  __m128i group = _mm_loadu_si128( (const __m128i*)tags );
+  return (u32)_mm_movemask_epi8( _mm_cmpeq_epi8( group, _mm_set1_epi8( (char)tag ) ) );
+#else
+  u32 mask = 0;
+  for( u32 i = 0; i < 16; i++ )
+    mask |= (u32)( tags[ i ] == tag ) << i;
+  return mask;
+#endif
 } // --------------------------------------------------------------------------
 
 // -------------------------------------------------------------------------------
 //  Structs
 // -------------------------------------------------------------------------------
-/** @brief Represents an entry in the hashtable */
-typedef struct entry
+/**
+  @brief Represents a slot in the hashtable, the key text lives in the name pool so a probe
+    only touches the hash and distance of each slot
+*/
+typedef struct slot
 {
-  char name[MAX_NAME_LENGTH];
   u64 hash;
-  u32 ref_count;
   void* data;
-  struct entry* next;
+  char* name;
+  u32 ref_count;
+  u32 distance;   // 0 when empty, otherwise the probe length from the home slot + 1
 
-} entry;
+} slot;
 // ---------------------------------------------------------------------------
 
 typedef struct hashtable_t
 {
-  entry** entries;
-  u32 capacity;
+  slot* slots;
+  u8* tags;                     // per slot 7 bits of the hash | 0x80, 0 when empty. The first
+                                //   GROUP_WIDTH - 1 tags are mirrored past the end for unaligned loads
+  memory_pool* name_pool;       // storage for the key text
+  memory_allocator allocator;   // source of the table, the slots and the name pool's chunks
+  const char* file;             // call site that created the table, its slots are charged to it
+  u32 line;
+  u32 capacity;                 // always a power of two
+  u32 mask;                     // capacity - 1
+  u32 count;
+  u32 max_distance;             // longest probe of any slot since the last resize
 
 } hashtable;
+
+// number of names the pool grows by
+#define NAME_POOL_CHUNK 32
+// number of tags compared at once
+#define GROUP_WIDTH 16
+// smallest slot array, a group never wraps over the same slot twice
+#define MIN_CAPACITY GROUP_WIDTH
 // ---------------------------------------------------------------------------
 
+// grow once the table is 7/8 full, Robin Hood keeps probes short well past that point
+static inline b8 needs_grow( hashtable* table )
+{
+  return (u64)( table->count + 1 ) * 8 > (u64)table->capacity * 7;
+} // -------------------------------------------------------------------------
+
+static inline u32 round_capacity( u32 capacity )
+{
+  u32 result = MIN_CAPACITY;
+  while( result < capacity && result < 0x80000000u ) result <<= 1;
+  return result;
+} // -------------------------------------------------------------------------
+
+// smallest capacity that holds count keys below the load factor
+static inline u32 capacity_for( u32 count )
+{
+  u32 result = MIN_CAPACITY;
+  while( (u64)result * 7 < (u64)count * 8 && result < 0x80000000u ) result <<= 1;
+  return result;
+} // -------------------------------------------------------------------------
+
+// tags use the top bits, the slot index uses the bottom ones
+static inline u8 hash_tag( u64 hash )
+{
+  return (u8)( ( hash >> 57 ) | 0x80 );
+} // -------------------------------------------------------------------------
+
+static inline u64 tags_bytes( u32 capacity )
+{
+  return capacity + GROUP_WIDTH - 1;
+} // -------------------------------------------------------------------------
+
+static inline void tag_write( hashtable* table, u32 index, u8 tag )
+{
+  table->tags[ index ] = tag;
+  if( index < GROUP_WIDTH - 1 ) table->tags[ table->capacity + index ] = tag;
+} // -------------------------------------------------------------------------
+
+static inline void slot_write( hashtable* table, u32 index, const slot* s )
+{
+  table->slots[ index ] = *s;
+  tag_write( table, index, hash_tag( s->hash ) );
+  if( s->distance > table->max_distance ) table->max_distance = s->distance;
+} // -------------------------------------------------------------------------
+
+// places an occupied slot, taking from the rich ( shorter probe ) to give to the poor
+static void slot_insert( hashtable* table, slot carried )
+{
+  u32 index = (u32)carried.hash & table->mask;
+  carried.distance = 1;
+
+  for( ;; )
+  {
+    slot* s = &table->slots[ index ];
+    if( s->distance == 0 )
+    {
+      slot_write( table, index, &carried );
+      return;
+    }
+
+    if( s->distance < carried.distance )
+    {
+      slot tmp = *s;
+      slot_write( table, index, &carried );
+      carried = tmp;
+    }
+
+    carried.distance++;
+    index = ( index + 1 ) & table->mask;
+  }
+} // -------------------------------------------------------------------------
+
+/*
+  returns the index of the key or -1, by_id matches on the hash alone and ignores key.  Each step
+  compares a group of 16 tags at once, only slots whose tag matches have their hash and name
+  checked.  A key never sits past an empty slot or further than max_distance from home, so most
+  lookups end within the first group
+*/
+static i64 slot_find( hashtable* table, string_view key, u64 hash, b8 by_id )
+{
+  u32 home = (u32)hash & table->mask;
+  u8 tag = hash_tag( hash );
+
+  for( u32 offset = 0; offset < table->max_distance; offset += GROUP_WIDTH )
+  {
+    u32 group = ( home + offset ) & table->mask;
+    u32 match = group_match( table->tags + group, tag );
+    u32 empty = group_match( table->tags + group, 0 );
+
+    // drop candidates after the first empty slot or past the longest probe
+    if( empty ) match &= ( empty & ( 0u - empty ) ) - 1;
+    u32 remaining = table->max_distance - offset;
+    if( remaining < GROUP_WIDTH ) match &= ( 1u << remaining ) - 1;
+
+    while( match )
+    {
+      u32 index = ( group + lowest_bit( match ) ) & table->mask;
+      slot* s = &table->slots[ index ];
+      if( s->hash == hash && ( by_id || string_view_is_equal_cstr( key, s->name ) ) ) return index;
+      match &= match - 1;
+    }
+
+    if( empty ) return -1;
+  }
+  return -1;
+} // -------------------------------------------------------------------------
+
+static b8 hashtable_resize( hashtable* table, u32 capacity )
+{
+  slot* slots = table->allocator.allocate( table->allocator.context, sizeof( slot ) * capacity, table->file, table->line );
+  u8* tags = table->allocator.allocate( table->allocator.context, tags_bytes( capacity ), table->file, table->line );
+  if( !slots || !tags )
+  {
+    if( slots ) table->allocator.free( table->allocator.context, slots, sizeof( slot ) * capacity );
+    if( tags ) table->allocator.free( table->allocator.context, tags, tags_bytes( capacity ) );
+    return false;
+  }
+  memory_zero( slots, sizeof( slot ) * capacity );
+  memory_zero( tags, tags_bytes( capacity ) );
+
+  slot* old = table->slots;
+  u8* old_tags = table->tags;
+  u32 old_capacity = table->capacity;
+
+  table->slots = slots;
+  table->tags = tags;
+  table->capacity = capacity;
+  table->mask = capacity - 1;
+  table->max_distance = 0;
+
+  // the names stay in the pool, only the slots move
+  for( u32 i = 0; i < old_capacity; i++ )
+  {
+    if( old[ i ].distance ) slot_insert( table, old[ i ] );
+  }
+
+  if( old ) table->allocator.free( table->allocator.context, old, sizeof( slot ) * old_capacity );
+  if( old_tags ) table->allocator.free( table->allocator.context, old_tags, tags_bytes( old_capacity ) );
+  return true;
+} // -------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------
 // Implementation
 // ---------------------------------------------------------------------------------
 
-hashtable *hashtable_create( u32 capacity )
+hashtable *_hashtable_create( u32 capacity, const char* file, u32 line )
 {
-  hashtable* table = memory_allocate( sizeof( struct hashtable_t ), MEM_TAG_HASHTABLE );
-  table->capacity = capacity;
-  table->entries = memory_allocate( sizeof( struct entry* ) * table->capacity, MEM_TAG_HASHTABLE );
-  memory_set( table->entries, 0, sizeof( entry* ) * table->capacity );
+  memory_allocator allocator = memory_allocator_heap( MEM_TAG_HASHTABLE );
+  return _hashtable_create_with_allocator( capacity, &allocator, file, line );
+} // -------------------------------------------------------------------------
+
+hashtable *_hashtable_create_with_allocator( u32 capacity, const memory_allocator* allocator, const char* file, u32 line )
+{
+  hashtable* table = allocator->allocate( allocator->context, sizeof( struct hashtable_t ), file, line );
+  if( !table ) return NULL;
+  table->slots = NULL;
+  table->tags = NULL;
+  table->capacity = 0;
+  table->mask = 0;
+  table->count = 0;
+  table->max_distance = 0;
+  table->allocator = *allocator;
+  table->file = file;
+  table->line = line;
+  table->name_pool = _memory_pool_create_with_allocator( MAX_NAME_LENGTH, NAME_POOL_CHUNK, allocator, file, line );
+  if( !table->name_pool || !hashtable_resize( table, round_capacity( capacity ) ) )
+  {
+    if( table->name_pool ) memory_pool_destroy( table->name_pool );
+    allocator->free( allocator->context, table, sizeof( struct hashtable_t ) );
+    return NULL;
+  }
   return table;
 } // -------------------------------------------------------------------------
 
@@ -61,91 +265,187 @@ void hashtable_destroy( hashtable *table, void (*destroy_fn)(void*) )
 {
   if( !table ) return;
 
-  for( u32 i = 0; i < table->capacity; i++ )
+  if( destroy_fn )
   {
-    entry* e = table->entries[ i ];
-    while( e )
+    for( u32 i = 0; i < table->capacity; i++ )
     {
-      entry* next = e->next;
-      if( e->data && destroy_fn )  destroy_fn( e->data );
-      memory_delete( e, sizeof( struct entry ), MEM_TAG_HASHTABLE );
-      e = next;
+      slot* s = &table->slots[ i ];
+      if( s->distance && s->data ) destroy_fn( s->data );
     }
   }
 
-  memory_delete( table->entries, sizeof( entry*) * table->capacity, MEM_TAG_HASHTABLE );
-  memory_delete( table, sizeof( hashtable ), MEM_TAG_HASHTABLE );
+  // releases every name at once
+  memory_pool_destroy( table->name_pool );
+  memory_allocator allocator = table->allocator;
+  allocator.free( allocator.context, table->slots, sizeof( slot ) * table->capacity );
+  allocator.free( allocator.context, table->tags, tags_bytes( table->capacity ) );
+  allocator.free( allocator.context, table, sizeof( hashtable ) );
   table = NULL;
 } // -------------------------------------------------------------------------
 
-void hashtable_set( hashtable *table, const char *key, void* value )
+b8 hashtable_set( hashtable *table, const char *key, void* value )
 {
-  u64 hash = fnv1a_hash64( key );
-  u32 bucket = hash % table->capacity;
+  if( !key )
+  {
+    FZY_WARNING( "hashtable set :: key is null" );
+    return false;
+  }
+
+  u64 hash = name_hash( key );
 
   // check if exists ( update resource )
-  for( entry* e = table->entries[ bucket ]; e; e = e->next )
+  i64 index = slot_find( table, string_view_from( key ), hash, false );
+  if( index >= 0 )
   {
-    if( e->hash == hash && string_is_equal( e->name, key ) )
-    {
-      e->ref_count++;
-      return;
-    }
+    table->slots[ index ].ref_count++;
+    return true;
+  }
+
+  #ifdef FZY_CONFIG_DEBUG
+    if( slot_find( table, string_view_create( NULL, 0 ), hash, true ) >= 0 )
+      FZY_WARNING( "hashtable set :: [ %s ] collides with another key, id lookups are ambiguous", key );
+  #endif
+
+  if( needs_grow( table ) && !hashtable_resize( table, table->capacity * 2 ) )
+  {
+    FZY_WARNING( "hashtable set :: failed to grow the table, [ %s ] was not added", key );
+    return false;
   }
 
   // not found, create a new entry
-  entry* entry = memory_allocate( sizeof( struct entry ), MEM_TAG_HASHTABLE );
-  entry->hash = hash;
-  string_copy( entry->name, 128, key );
-  entry->data = value;
-  entry->next = table->entries[ bucket ];
-  table->entries[ bucket ] = entry;
-  entry->ref_count = 1;
+  slot s;
+  s.hash = hash;
+  s.data = value;
+  s.ref_count = 1;
+  s.distance = 0;
+  s.name = memory_pool_allocate( table->name_pool, false );
+  string_copy( s.name, MAX_NAME_LENGTH, key );
+  slot_insert( table, s );
+  table->count++;
+  return true;
 } // -------------------------------------------------------------------------
 
 void *hashtable_get( hashtable *table, const char* key )
 {
-  u64 hash = fnv1a_hash64( key );
-  u32 bucket = hash & ( table->capacity - 1 );
+  if( !key ) return NULL;
 
-  for( entry *e = table->entries[ bucket ]; e; e = e->next )
+  i64 index = slot_find( table, string_view_from( key ), name_hash( key ), false );
+  if( index < 0 ) return NULL; // not found
+
+  slot* s = &table->slots[ index ];
+  s->ref_count += 1;
+  return s->data;
+} // -------------------------------------------------------------------------
+
+void *hashtable_get_view( hashtable *table, string_view key )
+{
+  if( !key.data ) return NULL;
+
+  i64 index = slot_find( table, key, name_hash_view( key ), false );
+  if( index < 0 ) return NULL; // not found
+
+  slot* s = &table->slots[ index ];
+  s->ref_count += 1;
+  return s->data;
+} // -------------------------------------------------------------------------
+
+void *hashtable_get_id( hashtable *table, name_id id )
+{
+  i64 index = slot_find( table, string_view_create( NULL, 0 ), id, true );
+  if( index < 0 ) return NULL; // not found
+
+  slot* s = &table->slots[ index ];
+  s->ref_count += 1;
+  return s->data;
+} // -------------------------------------------------------------------------
+
+void* hashtable_remove( hashtable* table, const char* key )
+{
+  if( !key ) return NULL;
+
+  i64 index = slot_find( table, string_view_from( key ), name_hash( key ), false );
+  if( index < 0 )
   {
-    if( e->hash == hash && string_is_equal( key, e->name ) )
-    {
-      e->ref_count += 1;
-      return e->data;
-    }
+    FZY_ERROR( "hashtable remove :: attempted to remove a non existing key" );
+    return NULL;
   }
-  return NULL; // not found
+
+  slot* s = &table->slots[ index ];
+  s->ref_count -= 1;
+  if( s->ref_count ) return NULL;
+
+  void* ret = s->data;
+  memory_pool_free( table->name_pool, s->name );
+  table->count--;
+
+  // shift the following run back by one instead of leaving a tombstone
+  u32 hole = (u32)index;
+  u32 next = ( hole + 1 ) & table->mask;
+  while( table->slots[ next ].distance > 1 )
+  {
+    table->slots[ hole ] = table->slots[ next ];
+    table->slots[ hole ].distance--;
+    tag_write( table, hole, table->tags[ next ] );
+    hole = next;
+    next = ( next + 1 ) & table->mask;
+  }
+  memory_zero( &table->slots[ hole ], sizeof( slot ) );
+  tag_write( table, hole, 0 );
+  return ret;
 } // -------------------------------------------------------------------------
 
-void* hashtable_remove( hashtable* table, const char* key )
+b8 hashtable_reserve( hashtable* table, u32 count )
+{
+  u32 capacity = capacity_for( count );
+  if( capacity <= table->capacity ) return true;
+  return hashtable_resize( table, capacity );
+} // -------------------------------------------------------------------------
+
+hashtable_iterator hashtable_iterate( hashtable* table )
+{
+  hashtable_iterator it = { table, 0, NULL, NULL, 0 };
+  return it;
+} // -------------------------------------------------------------------------
+
+b8 hashtable_next( hashtable_iterator* it )
 {
-  u64 hash = fnv1a_hash64( key );
-  u32 bucket = hash & (table->capacity - 1 );
+  hashtable* table = it->table;
+  while( it->index < table->capacity )
+  {
+    slot* s = &table->slots[ it->index++ ];
+    if( !s->distance ) continue;
 
-  entry *prev = NULL;
-  entry *e = table->entries[ bucket ];
+    it->key = s->name;
+    it->value = s->data;
+    it->ref_count = s->ref_count;
+    return true;
+  }
 
-  while( e )
+  it->key = NULL;
+  it->value = NULL;
+  it->ref_count = 0;
+  return false;
+} // -------------------------------------------------------------------------
+
+hashtable_stats hashtable_get_stats( hashtable* table )
+{
+  hashtable_stats stats;
+  u64 total_probe = 0;
+
+  stats.count = table->count;
+  stats.capacity = table->capacity;
+  stats.longest_probe = 0;
+  for( u32 i = 0; i < table->capacity; i++ )
   {
-    if( e->hash == hash && string_is_equal( e->name, key ) )
-    {
-      e->ref_count -= 1;
-      if( e->ref_count == 0 )
-      {
-        if( prev ) prev->next = e->next;
-        else table->entries[ bucket ] = e->next;
-
-        void* ret = e->data;
-        memory_delete( e, sizeof( struct entry ), MEM_TAG_HASHTABLE );
-        return ret;
-      }
-      return NULL;
-    }
-    prev = e;
-    e = e->next; // advance
+    u32 distance = table->slots[ i ].distance;
+    total_probe += distance;
+    if( distance > stats.longest_probe ) stats.longest_probe = distance;
   }
-  FZY_ERROR( "hashtable remove :: attempted to remove a non existing key" );
-  return NULL;
+
+  memory_pool_stats names = memory_pool_get_stats( table->name_pool );
+  stats.load_factor = (f32)table->count / (f32)table->capacity;
+  stats.average_probe = table->count ? (f32)total_probe / (f32)table->count : 0.0f;
+  stats.memory = sizeof( struct hashtable_t ) + sizeof( slot ) * table->capacity
+               + tags_bytes( table->capacity ) + names.block_size * names.capacity;
+  return stats;
 } // -------------------------------------------------------------------------
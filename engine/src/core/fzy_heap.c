@@ -0,0 +1,259 @@
+#include "core/fzy_heap.h"
+
+#include "core/fzy_mem.h"
+#include "core/fzy_logger.h"
+
+/*
+  @brief Represents a heap.  The elements are stored in heap order, handles and positions map
+    between an element's slot and its handle in both directions so a handle survives every move
+*/
+typedef struct heap
+{
+  u8 *elements;                 // heap order, the top is element 0
+  heap_handle *handles;         // handle of the element at each position
+  u32 *positions;               // position of each live handle, or the next free handle
+  u8 *temp;                     // one element of scratch, the element being sifted
+  u64 size;                     // The size of each element
+  heap_compare compare;
+  u32 arity;
+  u32 count;
+  u32 capacity;                 // slots in elements, handles and positions
+  u32 next_handle;              // handles below this have been handed out at least once
+  heap_handle free_handle;      // head of the list of released handles
+  memory_allocator allocator;   // Source of the heap and its arrays
+  const char *file;             // call site that created the heap, its arrays are charged to it
+  u32 line;
+
+} heap;
+// ---------------------------------------------------------------------------
+
+static inline u8 *heap_at( heap *heap, u32 position )
+{
+  return heap->elements + (u64)position * heap->size;
+} // ---------------------------------------------------------------------------
+
+static inline void heap_place( heap *heap, u32 position, const void *element, heap_handle handle )
+{
+  memory_copy( heap_at( heap, position ), element, heap->size );
+  heap->handles[ position ] = handle;
+  heap->positions[ handle ] = position;
+} // ---------------------------------------------------------------------------
+
+// moves the element at position toward the top, returns where it ended up
+static u32 heap_sift_up( heap *heap, u32 position )
+{
+  heap_handle handle = heap->handles[ position ];
+  memory_copy( heap->temp, heap_at( heap, position ), heap->size );
+
+  while( position > 0 )
+  {
+    u32 parent = ( position - 1 ) / heap->arity;
+    if( heap->compare( heap->temp, heap_at( heap, parent ) ) >= 0 ) break;
+
+    heap_place( heap, position, heap_at( heap, parent ), heap->handles[ parent ] );
+    position = parent;
+  }
+
+  heap_place( heap, position, heap->temp, handle );
+  return position;
+} // ---------------------------------------------------------------------------
+
+// moves the element at position toward the bottom, swapping with the child that comes out first
+static void heap_sift_down( heap *heap, u32 position )
+{
+  heap_handle handle = heap->handles[ position ];
+  memory_copy( heap->temp, heap_at( heap, position ), heap->size );
+
+  for( ;; )
+  {
+    u64 first = (u64)position * heap->arity + 1;
+    if( first >= heap->count ) break;
+
+    u32 last = first + heap->arity < heap->count ? (u32)first + heap->arity : heap->count;
+    u32 best = (u32)first;
+    for( u32 child = best + 1; child < last; child++ )
+    {
+      if( heap->compare( heap_at( heap, child ), heap_at( heap, best ) ) < 0 ) best = child;
+    }
+
+    if( heap->compare( heap_at( heap, best ), heap->temp ) >= 0 ) break;
+
+    heap_place( heap, position, heap_at( heap, best ), heap->handles[ best ] );
+    position = best;
+  }
+
+  heap_place( heap, position, heap->temp, handle );
+} // ---------------------------------------------------------------------------
+
+static b8 heap_grow( heap *heap )
+{
+  u32 capacity = heap->capacity ? heap->capacity * 2 : 16;
+  memory_allocator *a = &heap->allocator;
+
+  u8 *elements = a->reallocate( a->context, heap->elements, heap->size * heap->capacity, heap->size * capacity, heap->file, heap->line );
+  if( !elements ) return false;
+  heap->elements = elements;
+
+  heap_handle *handles = a->reallocate( a->context, heap->handles, sizeof( heap_handle ) * heap->capacity, sizeof( heap_handle ) * capacity,
+                                        heap->file, heap->line );
+  if( !handles ) return false;
+  heap->handles = handles;
+
+  u32 *positions = a->reallocate( a->context, heap->positions, sizeof( u32 ) * heap->capacity, sizeof( u32 ) * capacity,
+                                  heap->file, heap->line );
+  if( !positions ) return false;
+  heap->positions = positions;
+
+  // every array is at least the old size, capacity only changes once all three grew
+  heap->capacity = capacity;
+  return true;
+} // ---------------------------------------------------------------------------
+
+static b8 heap_handle_valid( heap *heap, heap_handle handle )
+{
+  return handle < heap->next_handle && heap->positions[ handle ] < heap->count
+      && heap->handles[ heap->positions[ handle ] ] == handle;
+} // ---------------------------------------------------------------------------
+
+// takes the element at position out of the heap and fills the hole with the last element
+static void heap_remove_at( heap *heap, u32 position, void *out )
+{
+  heap_handle handle = heap->handles[ position ];
+  if( out ) memory_copy( out, heap_at( heap, position ), heap->size );
+
+  heap->count--;
+  if( position != heap->count )
+  {
+    heap_place( heap, position, heap_at( heap, heap->count ), heap->handles[ heap->count ] );
+    if( heap_sift_up( heap, position ) == position ) heap_sift_down( heap, position );
+  }
+
+  heap->positions[ handle ] = heap->free_handle;
+  heap->free_handle = handle;
+} // ---------------------------------------------------------------------------
+
+heap *_heap_create( u64 element_size, u32 arity, heap_compare compare, u16 memory_tag, const char *file, u32 line )
+{
+  memory_allocator allocator = memory_allocator_heap( memory_tag );
+  return _heap_create_with_allocator( element_size, arity, compare, &allocator, file, line );
+} // ---------------------------------------------------------------------------
+
+heap *_heap_create_with_allocator( u64 element_size, u32 arity, heap_compare compare, const memory_allocator* allocator,
+                                   const char *file, u32 line )
+{
+  heap *h = allocator->allocate( allocator->context, sizeof( struct heap ), file, line );
+  if( !h ) return 0;
+
+  h->temp = allocator->allocate( allocator->context, element_size, file, line );
+  if( !h->temp )
+  {
+    allocator->free( allocator->context, h, sizeof( struct heap ) );
+    return 0;
+  }
+
+  if( arity == 0 ) arity = HEAP_DEFAULT_ARITY;
+  h->elements = 0;
+  h->handles = 0;
+  h->positions = 0;
+  h->size = element_size;
+  h->compare = compare;
+  h->arity = arity < 2 ? 2 : arity > 16 ? 16 : arity;
+  h->count = 0;
+  h->capacity = 0;
+  h->next_handle = 0;
+  h->free_handle = HEAP_INVALID_HANDLE;
+  h->allocator = *allocator;
+  h->file = file;
+  h->line = line;
+  return h;
+} // ---------------------------------------------------------------------------
+
+void heap_destroy( heap *heap )
+{
+  if( !heap ) return;
+
+  memory_allocator allocator = heap->allocator;
+  if( heap->elements ) allocator.free( allocator.context, heap->elements, heap->size * heap->capacity );
+  if( heap->handles ) allocator.free( allocator.context, heap->handles, sizeof( heap_handle ) * heap->capacity );
+  if( heap->positions ) allocator.free( allocator.context, heap->positions, sizeof( u32 ) * heap->capacity );
+  allocator.free( allocator.context, heap->temp, heap->size );
+  allocator.free( allocator.context, heap, sizeof( struct heap ) );
+} // ---------------------------------------------------------------------------
+
+heap_handle heap_push( heap *heap, const void *element )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( heap == 0 ) FZY_ERROR( "heap_push :: heap is null." );
+  #endif
+
+  if( heap->count == heap->capacity && !heap_grow( heap ) )
+  {
+    FZY_ERROR( "heap_push :: failed to grow the heap." );
+    return HEAP_INVALID_HANDLE;
+  }
+
+  // live handles never outnumber the slots, so a new handle always fits in positions
+  heap_handle handle = heap->free_handle;
+  if( handle != HEAP_INVALID_HANDLE ) heap->free_handle = heap->positions[ handle ];
+  else handle = heap->next_handle++;
+
+  heap_place( heap, heap->count++, element, handle );
+  heap_sift_up( heap, heap->count - 1 );
+  return handle;
+} // ---------------------------------------------------------------------------
+
+b8 heap_pop( heap *heap, void *out )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( heap == 0 ) FZY_ERROR( "heap_pop :: heap is null." );
+  #endif
+
+  if( !heap->count ) return false;
+  heap_remove_at( heap, 0, out );
+  return true;
+} // ---------------------------------------------------------------------------
+
+void *heap_peek( heap *heap )
+{
+  return heap->count ? heap->elements : 0;
+} // ---------------------------------------------------------------------------
+
+void *_heap_get( heap *heap, heap_handle handle )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( !heap_handle_valid( heap, handle ) ) FZY_ERROR( "_heap_get :: invalid handle %u.", handle );
+  #endif
+
+  return heap_at( heap, heap->positions[ handle ] );
+} // ---------------------------------------------------------------------------
+
+void heap_update( heap *heap, heap_handle handle )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( !heap_handle_valid( heap, handle ) ) FZY_ERROR( "heap_update :: invalid handle %u.", handle );
+  #endif
+
+  u32 position = heap->positions[ handle ];
+  if( heap_sift_up( heap, position ) == position ) heap_sift_down( heap, position );
+} // ---------------------------------------------------------------------------
+
+void heap_remove( heap *heap, heap_handle handle, void *out )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( !heap_handle_valid( heap, handle ) ) FZY_ERROR( "heap_remove :: invalid handle %u.", handle );
+  #endif
+
+  heap_remove_at( heap, heap->positions[ handle ], out );
+} // ---------------------------------------------------------------------------
+
+u32 heap_size( heap *heap )
+{
+  return heap->count;
+} // ---------------------------------------------------------------------------
+
+void heap_clear( heap *heap )
+{
+  heap->count = 0;
+  heap->next_handle = 0;
+  heap->free_handle = HEAP_INVALID_HANDLE;
+} // ---------------------------------------------------------------------------
@@ -1,19 +1,209 @@
 #include "core/fzy_mem.h"
 
 #include "core/fzy_logger.h"
+#include "core/fzy_atomic.h"
+#include "core/fzy_event.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+
+#ifdef FZY_PLATFORM_WINDOWS
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <unistd.h> // sysconf
+#include <sys/mman.h>
+#endif
 
 struct memory_stats
 {
   u64 total_allocated;
   u64 tagged_allocations[MEM_TAG_MAX_TAGS];
+  u64 frame_allocations[MEM_TAG_MAX_TAGS];   // frame arena usage for the current frame
+  u64 huge_allocations[MEM_TAG_MAX_TAGS];    // bytes backed by huge pages
 };
 
 static struct memory_stats stats;
 
+/* @brief Byte limits for a memory tag, 0 disables the limit */
+typedef struct memory_budget
+{
+  u64 soft;   // listeners are told when usage rises past this
+  u64 hard;   // allocations that would rise past this fail
+
+} memory_budget;
+
+static memory_budget budgets[ MEM_TAG_MAX_TAGS ];
+
+/* @brief A budget event latched by the allocating thread, fired later from the main thread */
+typedef struct budget_crossing
+{
+  u64 bytes;     // bytes in use for a soft crossing, bytes requested for a hard refusal
+  u32 latched;   // set when the event is waiting to be fired
+
+} budget_crossing;
+
+static budget_crossing soft_crossings[ MEM_TAG_MAX_TAGS ];
+static budget_crossing hard_crossings[ MEM_TAG_MAX_TAGS ];
+
+/* @brief How a block mapped for huge pages ended up backed */
+typedef enum huge_page_kind
+{
+  HUGE_PAGES_NONE = 0,      // the host refused, regular pages
+  HUGE_PAGES_TRANSPARENT,   // advised for transparent huge pages, the kernel promotes them
+  HUGE_PAGES_EXPLICIT       // reserved huge pages ( MAP_HUGETLB / MEM_LARGE_PAGES )
+
+} huge_page_kind;
+
+static const char* huge_page_kind_strings[ 3 ] = { "none", "transparent", "explicit" };
+
+/* @brief Linear arena that is reset at the end of every frame */
+typedef struct frame_arena
+{
+  u8 *memory;       // backing block for the arena
+  u64 capacity;     // size in bytes of the backing block
+  u64 offset;       // the next free byte in the arena
+  u64 high_water;   // the most bytes used in a single frame
+  b8 mapped;        // the block was mapped for huge pages rather than allocated
+  huge_page_kind huge_pages;
+
+} frame_arena;
+
+static frame_arena frame;
+
+// number of huge page backed blocks remembered so their bytes can be taken off the statistics when freed
+#define HUGE_BLOCK_SLOTS 64
+
+/* @brief The huge page backed blocks handed out by memory_allocate_huge */
+typedef struct huge_block_registry
+{
+  void* blocks[ HUGE_BLOCK_SLOTS ];
+  u32 lock;
+
+} huge_block_registry;
+
+static huge_block_registry huge_blocks;
+
+// alignment of every block handed out by the linear arenas
+#define ARENA_ALIGNMENT 16
+
+// virtual arenas commit at least this many bytes at a time
+#define VIRTUAL_COMMIT_GRANULARITY ( 64 * 1024 )
+
+// blocks up to this size are recycled through the per-thread cache
+#define THREAD_CACHE_MAX_BLOCK 256
+
+// size classes held by the cache, 16, 32, 64, 128 and 256 bytes
+#define THREAD_CACHE_CLASSES 5
+
+// number of free blocks kept for each size class
+#define THREAD_CACHE_DEPTH 32
+
+// every cached block carries its size class in front of it, 16 bytes keeps the block 16 byte aligned
+#define CACHE_HEADER_SIZE 16
+
+// size class stored for blocks too big for the cache
+#define CACHE_CLASS_NONE 0xFFFFFFFFu
+
+/* @brief Small blocks freed by a thread, reused by its next allocations without touching the host */
+typedef struct thread_cache
+{
+  void* blocks[ THREAD_CACHE_CLASSES ][ THREAD_CACHE_DEPTH ];
+  u32 count[ THREAD_CACHE_CLASSES ];
+
+} thread_cache;
+
+static FZY_THREAD_LOCAL thread_cache cache;
+
+// each thread's scratch stack, created by memory_scratch_stack
+static FZY_THREAD_LOCAL memory_stack scratch;
+
+// initial number of slots in the allocation tracker, always a power of two
+#define TRACKER_INITIAL_CAPACITY 1024
+
+/* @brief A live allocation and the call site that made it */
+typedef struct allocation_record
+{
+  void* block;          // the address handed out, 0 marks an empty slot
+  u64 size;             // the size requested
+  const char* file;     // source file of the call site
+  u32 line;             // source line of the call site
+  fzy_memory_tag tag;   // the memory tag of the allocation
+
+} allocation_record;
+
+/* @brief Open addressed table of live allocations keyed by address */
+typedef struct allocation_tracker
+{
+  allocation_record* records;   // slots, allocated from the host so they are never tracked themselves
+  u64 capacity;                 // number of slots
+  u64 count;                    // number of live records
+  u32 lock;                     // spin lock, allocations can come from any thread
+  b8 enabled;                   // records are only added while enabled
+
+} allocation_tracker;
+
+static allocation_tracker tracker;
+
+/* @brief Live allocations from a single call site */
+typedef struct allocation_site
+{
+  const char* file;
+  u32 line;
+  fzy_memory_tag tag;
+  i64 count;            // number of live allocations, negative in a diff when they shrank
+  i64 bytes;            // bytes held by the allocations, negative in a diff when they shrank
+
+} allocation_site;
+
+typedef struct memory_snapshot
+{
+  allocation_site* sites;   // sorted by call site
+  u64 count;
+
+} memory_snapshot;
+
+/* @brief Growable text used to build the report strings */
+typedef struct text_buffer
+{
+  char* data;
+  u64 length;
+  u64 capacity;
+
+} text_buffer;
+
+/* @brief A chunk of blocks owned by a pool, the blocks follow the header in memory */
+typedef struct pool_chunk
+{
+  struct pool_chunk* next;   // the next chunk owned by the pool
+  u64 padding;               // keeps the blocks 16 byte aligned
+
+} pool_chunk;
+
+/* @brief A free block in a pool, the link is stored in the block itself */
+typedef struct pool_block
+{
+  struct pool_block* next;   // the next free block
+
+} pool_block;
+
+typedef struct memory_pool
+{
+  pool_chunk* chunks;        // every chunk allocated by the pool
+  pool_block* free_list;     // blocks ready to be handed out
+  u64 block_size;            // size of each block, padded to hold a free list link
+  u32 blocks_per_chunk;      // number of blocks added when the pool grows
+  u32 capacity;              // total number of blocks in the pool
+  u32 used;                  // number of blocks handed out
+  u32 peak;                  // most blocks handed out at once
+  memory_allocator allocator;   // source of the pool header and its chunks
+  const char* file;          // call site that created the pool, its chunks are charged to it
+  u32 line;
+
+} memory_pool;
+
 
 static const char* memory_tag_strings[MEM_TAG_MAX_TAGS] = {
   "UNKNOWN    ",
@@ -32,136 +222,1481 @@ static const char* memory_tag_strings[MEM_TAG_MAX_TAGS] = {
   "ENTITY     ",
   "COMPONENT  ",
   "PROCESS    ",
+  "SCRATCH    ",
 };
 
-static void *allocate( u64 size, b8 aligned )
+// alignment of 0 uses the default alignment of the host allocator
+static void *allocate( u64 size, u64 alignment, b8 zero )
+{
+  if( !alignment )
+  {
+    // calloc lets the host hand out pages that are already zeroed
+    return zero ? calloc( 1, size ) : malloc( size );
+  }
+
+  void *block = 0;
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    block = _aligned_malloc( size, alignment );
+  #else
+    if( alignment < sizeof( void* ) ) alignment = sizeof( void* );
+    if( posix_memalign( &block, alignment, size ) != 0 ) block = 0;
+  #endif
+
+  if( block && zero ) memory_zero( block, size );
+  return block;
+} // -----------------------------------------------------------------------
+
+static void delete( void *block, u64 alignment )
 {
-  return malloc( size );
+  #ifdef FZY_PLATFORM_WINDOWS
+    if( alignment )
+    {
+      _aligned_free( block );
+      return;
+    }
+  #else
+    (void)alignment;
+  #endif
+  free( block );
 } // -----------------------------------------------------------------------
 
-static void *reallocate( void *block, u64 size, b8 aligned )
+static void *reallocate( void *block, u64 old_size, u64 size, u64 alignment )
 {
-   return realloc( block, size );
+  if( !alignment ) return realloc( block, size );
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    return _aligned_realloc( block, size, alignment );
+  #else
+    // there is no aligned realloc on posix, move the block by hand
+    void *new_block = allocate( size, alignment, false );
+    if( !new_block ) return 0;
+    if( block )
+    {
+      memcpy( new_block, block, old_size < size ? old_size : size );
+      delete( block, alignment );
+    }
+    return new_block;
+  #endif
 } // -----------------------------------------------------------------------
 
-static void delete( void *block, b8 aligned )
+// returns the cache size class able to hold size bytes
+static inline u32 cache_class( u64 size )
 {
-  free( block );
+  u32 c = 0;
+  while( ( (u64)16 << c ) < size ) c++;
+  return c;
 } // -----------------------------------------------------------------------
 
-b8 memory_initialize( )
+// the size class of a block handed out by cached_allocate, kept in the header in front of it
+static inline u32* cache_header( void* block )
 {
-  return true;
+  return (u32*)( (u8*)block - CACHE_HEADER_SIZE );
 } // -----------------------------------------------------------------------
 
-b8 memory_shutdown( )
+static void *cache_block( void* raw, u32 size_class )
 {
-  return true;
+  if( !raw ) return 0;
+  *(u32*)raw = size_class;
+  return (u8*)raw + CACHE_HEADER_SIZE;
 } // -----------------------------------------------------------------------
 
-void* memory_allocate( u64 size, fzy_memory_tag tag )
+static void *cached_allocate( u64 size, b8 zero )
 {
-  if( tag == MEM_TAG_UNKNOWN )
-    FZY_WARNING( "memory_allocate called using MEMORY_TAG_UNKNOWN.  Re-class this allocation." );
+  if( size > THREAD_CACHE_MAX_BLOCK )
+    return cache_block( allocate( size + CACHE_HEADER_SIZE, 0, zero ), CACHE_CLASS_NONE );
 
-  stats.total_allocated += size;
-  stats.tagged_allocations[ tag ] += size;
+  u32 c = cache_class( size );
+  if( cache.count[ c ] )
+  {
+    void *block = cache.blocks[ c ][ --cache.count[ c ] ];
+    if( zero ) memory_zero( block, size );
+    return block;
+  }
 
-  // TODO : memory alignment
-  void *block = allocate( size, false );
-  return memory_zero( block, size );
+  // always allocate the full class so the block can be recycled for any size in it
+  return cache_block( allocate( ( (u64)16 << c ) + CACHE_HEADER_SIZE, 0, zero ), c );
 } // -----------------------------------------------------------------------
 
-void memory_delete( void *block, u64 size, fzy_memory_tag tag )
+// the class comes from the block's header, not the size the caller frees with, so a wrong size can't
+// push a small block into a bigger class
+static void cached_delete( void *block )
 {
-  if( tag == MEM_TAG_UNKNOWN )
-    FZY_WARNING( "memory_free called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+  if( !block ) return;
+  u32 c = *cache_header( block );
+  if( c < THREAD_CACHE_CLASSES && cache.count[ c ] < THREAD_CACHE_DEPTH )
+  {
+    cache.blocks[ c ][ cache.count[ c ]++ ] = block;
+    return;
+  }
+  delete( cache_header( block ), 0 );
+} // -----------------------------------------------------------------------
 
-  stats.total_allocated -= size;
-  i64 remove = (i64)stats.tagged_allocations - size;
-  if( remove < 0 )
-    FZY_ERROR( "memory_free :: freeing more than allocated" );
-  stats.tagged_allocations[ tag ] -= size;
+static void *cached_reallocate( void *block, u64 old_size, u64 size )
+{
+  if( !block ) return cached_allocate( size, false );
+
+  u32 c = *cache_header( block );
+  if( c < THREAD_CACHE_CLASSES )
+  {
+    if( size <= ( (u64)16 << c ) ) return block;
+    // never copy past the end of the class, whatever the caller says the old size was
+    if( old_size > ( (u64)16 << c ) ) old_size = (u64)16 << c;
+  }
+  else if( size > THREAD_CACHE_MAX_BLOCK )
+  {
+    return cache_block( reallocate( cache_header( block ), old_size + CACHE_HEADER_SIZE,
+                                    size + CACHE_HEADER_SIZE, 0 ), CACHE_CLASS_NONE );
+  }
 
-  // TODO: memory alignment
-  delete( block, false );
-  block = 0;
+  void *new_block = cached_allocate( size, false );
+  if( !new_block ) return 0;
+  memory_copy( new_block, block, old_size < size ? old_size : size );
+  cached_delete( block );
+  return new_block;
 } // -----------------------------------------------------------------------
 
-void* memory_reallocate( void* block, u64 old_size, u64 new_size, fzy_memory_tag tag )
+static void cache_flush( void )
 {
-  if( tag == MEM_TAG_UNKNOWN )
-    FZY_WARNING( "memory_reallocate called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
-
-  i64 change = new_size - old_size;
-  stats.total_allocated += change;
-  stats.tagged_allocations[ tag ] += change;
+  for( u32 c = 0; c < THREAD_CACHE_CLASSES; c++ )
+  {
+    while( cache.count[ c ] )
+      delete( cache_header( cache.blocks[ c ][ --cache.count[ c ] ] ), 0 );
+  }
+} // -----------------------------------------------------------------------
 
-  // TODO: memory alignment
-  block = reallocate( block, new_size, false );
-  return block;
+// allocations come from any thread and listeners may allocate, so only record the event here
+static void budget_latch( budget_crossing* crossing, u64 bytes )
+{
+  atomic_u64_store( &crossing->bytes, bytes );
+  atomic_u32_store( &crossing->latched, 1 );
 } // -----------------------------------------------------------------------
 
-i32 memory_compare( void* add1, void *add2, u64 size )
+static void budget_fire( budget_crossing* crossing, u16 code, fzy_memory_tag tag )
 {
-  return memcmp( add1, add2, size );
-} // ----------------------------------------------------------------------
+  if( !atomic_u32_load( &crossing->latched ) ) return;
+  atomic_u32_store( &crossing->latched, 0 );
 
-void* memory_zero( void *block, u64 size )
+  event_context context;
+  context.data.u64[ 0 ] = tag;
+  context.data.u64[ 1 ] = atomic_u64_load( &crossing->bytes );
+  event_fire( code, 0, context );
+} // -----------------------------------------------------------------------
+
+// returns false without counting the bytes when they would exceed the tag's hard budget
+static b8 track_allocation( u64 size, fzy_memory_tag tag )
 {
-  return memset( block, 0, size );
+  u64 previous = atomic_u64_add( &stats.tagged_allocations[ tag ], size );
+  u64 current = previous + size;
+  memory_budget budget = budgets[ tag ];
+
+  if( budget.hard && current > budget.hard )
+  {
+    atomic_u64_sub( &stats.tagged_allocations[ tag ], size );
+    FZY_WARNING( "memory_allocate :: %llu bytes refused, %s is over its hard budget of %llu bytes",
+                 (unsigned long long)size, memory_tag_strings[ tag ], (unsigned long long)budget.hard );
+    budget_latch( &hard_crossings[ tag ], size );
+    return false;
+  }
+
+  atomic_u64_add( &stats.total_allocated, size );
+
+  // only the allocation that rises past the limit latches, so listeners hear about it once per crossing
+  if( budget.soft && previous < budget.soft && current >= budget.soft )
+    budget_latch( &soft_crossings[ tag ], current );
+
+  return true;
 } // -----------------------------------------------------------------------
 
-void* memory_copy( void *dest, const void *source, u64 size )
+static void track_free( u64 size, fzy_memory_tag tag )
 {
-  return memcpy( dest, source, size );
+  u64 previous = atomic_u64_sub( &stats.tagged_allocations[ tag ], size );
+  if( previous < size )
+    FZY_ERROR( "memory_free :: freeing more than allocated" );
+
+  atomic_u64_sub( &stats.total_allocated, size );
 } // -----------------------------------------------------------------------
 
-void *memory_set( void *dest, i32 value, u64 size )
+// counts only the change in size, so a tag already past its soft budget doesn't cross it again
+static b8 track_reallocation( u64 old_size, u64 new_size, fzy_memory_tag tag )
 {
-  return memset( dest, value, size );
+  if( new_size > old_size ) return track_allocation( new_size - old_size, tag );
+
+  track_free( old_size - new_size, tag );
+  return true;
 } // -----------------------------------------------------------------------
 
-char* memory_get_usage_str( )
+static const char* format_size( u64 bytes, f32 *amount )
 {
   const u64 gib = 1024 * 1024 * 1024;
   const u64 mib = 1024 * 1024;
   const u64 kib = 1024;
 
-  char buffer[ 8000 ] = "System memory usage (tagged):\n";
-  u64 offset = strlen( buffer );
+  if( bytes >= gib )
+  {
+    *amount = bytes / (f32)gib;
+    return "GiB";
+  }
+  if( bytes >= mib )
+  {
+    *amount = bytes / (f32)mib;
+    return "MiB";
+  }
+  if( bytes >= kib )
+  {
+    *amount = bytes / (f32)kib;
+    return "KiB";
+  }
+  *amount = (f32)bytes;
+  return "B";
+} // -----------------------------------------------------------------------
 
-  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+static void text_append( text_buffer* text, const char* format, ... )
+{
+  va_list args;
+  va_start( args, format );
+  i32 needed = vsnprintf( 0, 0, format, args );
+  va_end( args );
+  if( needed <= 0 ) return;
+
+  if( text->length + needed + 1 > text->capacity )
+  {
+    u64 capacity = text->capacity ? text->capacity : 1024;
+    while( text->length + needed + 1 > capacity ) capacity *= 2;
+    char* data = realloc( text->data, capacity );
+    if( !data ) return;
+    text->data = data;
+    text->capacity = capacity;
+  }
+
+  va_start( args, format );
+  vsnprintf( text->data + text->length, text->capacity - text->length, format, args );
+  va_end( args );
+  text->length += needed;
+} // -----------------------------------------------------------------------
+
+// moves the text into a string the caller frees with string_free
+static char* text_finish( text_buffer* text )
+{
+  char* out_string = memory_allocate( text->length + 1, MEM_TAG_STRING );
+  if( text->length ) memory_copy( out_string, text->data, text->length );
+  out_string[ text->length ] = 0;
+  free( text->data );
+  text->data = 0;
+  text->length = 0;
+  text->capacity = 0;
+  return out_string;
+} // -----------------------------------------------------------------------
+
+static void spin_lock( volatile u32* lock )
+{
+  u32 expected = 0;
+  while( !atomic_u32_compare_exchange( lock, &expected, 1 ) )
+    expected = 0;
+} // -----------------------------------------------------------------------
+
+static void spin_unlock( volatile u32* lock )
+{
+  atomic_u32_store( lock, 0 );
+} // -----------------------------------------------------------------------
+
+static void tracker_lock( void )
+{
+  spin_lock( &tracker.lock );
+} // -----------------------------------------------------------------------
+
+static void tracker_unlock( void )
+{
+  spin_unlock( &tracker.lock );
+} // -----------------------------------------------------------------------
+
+static inline u64 tracker_slot( void* block, u64 capacity )
+{
+  // fibonacci hashing, the low bits of an address are mostly alignment
+  return ( ( (u64)block >> 4 ) * 11400714819323198485ull ) & ( capacity - 1 );
+} // -----------------------------------------------------------------------
+
+static void tracker_insert_record( allocation_record* records, u64 capacity, allocation_record* record )
+{
+  u64 slot = tracker_slot( record->block, capacity );
+  while( records[ slot ].block )
+    slot = ( slot + 1 ) & ( capacity - 1 );
+  records[ slot ] = *record;
+} // -----------------------------------------------------------------------
+
+static b8 tracker_grow( void )
+{
+  u64 capacity = tracker.capacity ? tracker.capacity * 2 : TRACKER_INITIAL_CAPACITY;
+  allocation_record* records = calloc( capacity, sizeof( allocation_record ) );
+  if( !records ) return false;
+
+  for( u64 i = 0; i < tracker.capacity; i++ )
+  {
+    if( tracker.records[ i ].block )
+      tracker_insert_record( records, capacity, &tracker.records[ i ] );
+  }
+  free( tracker.records );
+  tracker.records = records;
+  tracker.capacity = capacity;
+  return true;
+} // -----------------------------------------------------------------------
+
+static void tracker_add( void* block, u64 size, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( !tracker.enabled || !block ) return;
+
+  tracker_lock();
+  // keep the table at most half full so probe sequences stay short
+  if( ( tracker.count + 1 ) * 2 > tracker.capacity && !tracker_grow() )
+  {
+    tracker_unlock();
+    return;
+  }
+
+  allocation_record record = { block, size, file, line, tag };
+  tracker_insert_record( tracker.records, tracker.capacity, &record );
+  tracker.count++;
+  tracker_unlock();
+} // -----------------------------------------------------------------------
+
+static void tracker_remove( void* block, u64 size )
+{
+  if( !block || !tracker.capacity ) return;
+
+  tracker_lock();
+  u64 mask = tracker.capacity - 1;
+  u64 slot = tracker_slot( block, tracker.capacity );
+  while( tracker.records[ slot ].block && tracker.records[ slot ].block != block )
+    slot = ( slot + 1 ) & mask;
+
+  // blocks allocated while tracking was disabled have no record
+  if( !tracker.records[ slot ].block )
+  {
+    tracker_unlock();
+    return;
+  }
+
+  if( tracker.records[ slot ].size != size )
+  {
+    FZY_WARNING( "memory_delete :: block from %s:%u was allocated with %llu bytes but freed with %llu",
+                 tracker.records[ slot ].file, tracker.records[ slot ].line,
+                 (unsigned long long)tracker.records[ slot ].size, (unsigned long long)size );
+  }
+
+  // shift the following records back so no tombstones are needed
+  u64 hole = slot;
+  u64 next = ( slot + 1 ) & mask;
+  while( tracker.records[ next ].block )
+  {
+    u64 home = tracker_slot( tracker.records[ next ].block, tracker.capacity );
+    if( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )
+    {
+      tracker.records[ hole ] = tracker.records[ next ];
+      hole = next;
+    }
+    next = ( next + 1 ) & mask;
+  }
+  tracker.records[ hole ].block = 0;
+  tracker.count--;
+  tracker_unlock();
+} // -----------------------------------------------------------------------
+
+static inline b8 wants_huge_pages( u64 size )
+{
+  return FZY_HUGE_PAGE_THRESHOLD && size >= FZY_HUGE_PAGE_THRESHOLD;
+} // -----------------------------------------------------------------------
+
+#ifndef FZY_PLATFORM_WINDOWS
+// maps size bytes starting on a multiple of alignment, the slack around the range is given back
+static void *map_aligned( u64 size, u64 alignment, i32 protection, i32 flags )
+{
+  u8 *raw = mmap( 0, size + alignment, protection, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0 );
+  if( raw == MAP_FAILED ) return 0;
+
+  u8 *aligned = (u8*)( ( (u64)raw + ( alignment - 1 ) ) & ~( alignment - 1 ) );
+  if( aligned > raw ) munmap( raw, aligned - raw );
+  u64 tail = ( raw + size + alignment ) - ( aligned + size );
+  if( tail ) munmap( aligned + size, tail );
+  return aligned;
+} // -----------------------------------------------------------------------
+#endif
+
+// size must be a multiple of the huge page size, the block comes back zeroed
+static void *map_huge( u64 size, huge_page_kind *kind )
+{
+  *kind = HUGE_PAGES_NONE;
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    void *block = 0;
+    if( GetLargePageMinimum() )
+      block = VirtualAlloc( 0, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+    if( block )
+    {
+      *kind = HUGE_PAGES_EXPLICIT;
+      return block;
+    }
+    // large pages need the lock pages privilege, fall back to regular pages
+    return VirtualAlloc( 0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+  #else
+    #ifdef MAP_HUGETLB
+      void *block = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+      if( block != MAP_FAILED )
+      {
+        *kind = HUGE_PAGES_EXPLICIT;
+        return block;
+      }
+    #endif
+
+    // no reserved huge pages, ask for transparent ones on a huge page aligned range
+    void *aligned = map_aligned( size, memory_huge_page_size(), PROT_READ | PROT_WRITE, 0 );
+    #ifdef MADV_HUGEPAGE
+      if( aligned && madvise( aligned, size, MADV_HUGEPAGE ) == 0 ) *kind = HUGE_PAGES_TRANSPARENT;
+    #endif
+    return aligned;
+  #endif
+} // -----------------------------------------------------------------------
+
+static void unmap_huge( void *block, u64 size )
+{
+  #ifdef FZY_PLATFORM_WINDOWS
+    VirtualFree( block, 0, MEM_RELEASE );
+  #else
+    munmap( block, size );
+  #endif
+} // -----------------------------------------------------------------------
+
+// returns false when every slot is taken and the block could not be registered
+static b8 huge_block_add( void *block )
+{
+  b8 added = false;
+  spin_lock( &huge_blocks.lock );
+  for( u32 i = 0; i < HUGE_BLOCK_SLOTS; i++ )
   {
-    char unit[ 4 ] = "xiB";
-    float amount = 1.0f;
+    if( !huge_blocks.blocks[ i ] )
+    {
+      huge_blocks.blocks[ i ] = block;
+      added = true;
+      break;
+    }
+  }
+  spin_unlock( &huge_blocks.lock );
+  return added;
+} // -----------------------------------------------------------------------
 
-    if( stats.tagged_allocations[ i ] >= gib )
+// returns true if the block was registered as huge page backed
+static b8 huge_block_remove( void *block )
+{
+  b8 found = false;
+  spin_lock( &huge_blocks.lock );
+  for( u32 i = 0; i < HUGE_BLOCK_SLOTS; i++ )
+  {
+    if( huge_blocks.blocks[ i ] == block )
     {
-      unit[ 0 ] = 'G';
-      amount = stats.tagged_allocations[ i ] / (float)gib;
+      huge_blocks.blocks[ i ] = 0;
+      found = true;
+      break;
     }
-    else if( stats.tagged_allocations[ i ] >= mib )
+  }
+  spin_unlock( &huge_blocks.lock );
+  return found;
+} // -----------------------------------------------------------------------
+
+static i32 site_compare( const void* a, const void* b )
+{
+  const allocation_site* x = a;
+  const allocation_site* y = b;
+  i32 result = strcmp( x->file, y->file );
+  if( result ) return result;
+  if( x->line != y->line ) return x->line < y->line ? -1 : 1;
+  if( x->tag != y->tag ) return x->tag < y->tag ? -1 : 1;
+  return 0;
+} // -----------------------------------------------------------------------
+
+static i32 site_compare_bytes( const void* a, const void* b )
+{
+  const allocation_site* x = a;
+  const allocation_site* y = b;
+  if( x->bytes != y->bytes ) return x->bytes > y->bytes ? -1 : 1;
+  return site_compare( a, b );
+} // -----------------------------------------------------------------------
+
+// gathers the live records into one entry per call site, sorted by call site
+static memory_snapshot* snapshot_collect( void )
+{
+  memory_snapshot* snapshot = calloc( 1, sizeof( memory_snapshot ) );
+  if( !snapshot ) return 0;
+
+  tracker_lock();
+  if( tracker.count )
+    snapshot->sites = malloc( tracker.count * sizeof( allocation_site ) );
+  if( snapshot->sites )
+  {
+    for( u64 i = 0; i < tracker.capacity; i++ )
     {
-      unit[ 0 ] = 'M';
-      amount = stats.tagged_allocations[ i ] / (float)mib;
+      allocation_record* record = &tracker.records[ i ];
+      if( !record->block ) continue;
+      allocation_site site = { record->file, record->line, record->tag, 1, (i64)record->size };
+      snapshot->sites[ snapshot->count++ ] = site;
     }
-    else if( stats.tagged_allocations[ i ] >= kib )
+  }
+  tracker_unlock();
+
+  if( !snapshot->count ) return snapshot;
+
+  qsort( snapshot->sites, snapshot->count, sizeof( allocation_site ), site_compare );
+
+  // merge runs of the same call site
+  u64 out = 0;
+  for( u64 i = 1; i < snapshot->count; i++ )
+  {
+    if( site_compare( &snapshot->sites[ out ], &snapshot->sites[ i ] ) == 0 )
     {
-      unit[ 0 ] = 'K';
-      amount = stats.tagged_allocations[ i ] / (float)kib;
+      snapshot->sites[ out ].count += snapshot->sites[ i ].count;
+      snapshot->sites[ out ].bytes += snapshot->sites[ i ].bytes;
     }
     else
     {
-      unit[ 0 ] = 'B';
-      unit[ 1 ] = 0;
-      amount = (float)stats.tagged_allocations[ i ];
+      snapshot->sites[ ++out ] = snapshot->sites[ i ];
     }
+  }
+  snapshot->count = out + 1;
+  return snapshot;
+} // -----------------------------------------------------------------------
+
+b8 memory_initialize( )
+{
+  if( frame.memory ) return false;
 
-    i32 length = snprintf( buffer + offset, 8000, "  %s: %.2f%s\n", memory_tag_strings[ i ], amount, unit );
-    offset += length;
+  frame.capacity = FZY_FRAME_ARENA_SIZE;
+  frame.mapped = wants_huge_pages( FZY_FRAME_ARENA_SIZE );
+  frame.huge_pages = HUGE_PAGES_NONE;
+  if( frame.mapped )
+  {
+    // the arena is touched every frame, keep it on as few TLB entries as possible
+    u64 huge = memory_huge_page_size();
+    frame.capacity = ( frame.capacity + ( huge - 1 ) ) & ~( huge - 1 );
+    frame.memory = map_huge( frame.capacity, &frame.huge_pages );
+  }
+  else
+  {
+    frame.memory = allocate( FZY_FRAME_ARENA_SIZE, memory_page_size(), false );
   }
+  if( !frame.memory ) return false;
 
-  char* out_string = strdup( buffer );
-  return out_string;
+  frame.offset = 0;
+  frame.high_water = 0;
+
+  #ifdef FZY_CONFIG_DEBUG
+    memory_tracking_enable( true );
+  #endif
+  return true;
+} // -----------------------------------------------------------------------
+
+b8 memory_shutdown( )
+{
+  memory_stack_destroy( &scratch );
+  if( tracker.enabled ) memory_report_leaks();
+
+  tracker.enabled = false;
+  free( tracker.records );
+  tracker.records = 0;
+  tracker.capacity = 0;
+  tracker.count = 0;
+
+  cache_flush();
+
+  if( frame.memory )
+  {
+    if( frame.mapped ) unmap_huge( frame.memory, frame.capacity );
+    else delete( frame.memory, memory_page_size() );
+    frame.memory = 0;
+    frame.capacity = 0;
+    frame.offset = 0;
+  }
+  return true;
+} // -----------------------------------------------------------------------
+
+void* _memory_allocate( u64 size, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_allocate called using MEMORY_TAG_UNKNOWN.  Re-class this allocation." );
+
+  if( !track_allocation( size, tag ) ) return 0;
+
+  void* block = cached_allocate( size, true );
+  tracker_add( block, size, tag, file, line );
+  return block;
+} // -----------------------------------------------------------------------
+
+void* _memory_allocate_uninitialized( u64 size, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_allocate_uninitialized called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  if( !track_allocation( size, tag ) ) return 0;
+
+  void* block = cached_allocate( size, false );
+  tracker_add( block, size, tag, file, line );
+  return block;
+} // -----------------------------------------------------------------------
+
+void memory_delete( void *block, u64 size, fzy_memory_tag tag )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_free called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  track_free( size, tag );
+  tracker_remove( block, size );
+  cached_delete( block );
+} // -----------------------------------------------------------------------
+
+void* _memory_reallocate( void* block, u64 old_size, u64 new_size, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_reallocate called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  // the old block is left untouched when the growth is refused
+  if( !track_reallocation( old_size, new_size, tag ) ) return 0;
+  tracker_remove( block, old_size );
+
+  void* new_block = cached_reallocate( block, old_size, new_size );
+  tracker_add( new_block, new_size, tag, file, line );
+  return new_block;
+} // -----------------------------------------------------------------------
+
+void* _memory_allocate_aligned( u64 size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_allocate_aligned called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  #ifdef FZY_CONFIG_DEBUG
+    if( !alignment || ( alignment & ( alignment - 1 ) ) )
+      FZY_ERROR( "memory_allocate_aligned :: alignment %llu is not a power of two", (unsigned long long)alignment );
+  #endif
+
+  if( !track_allocation( size, tag ) ) return 0;
+
+  void* block = allocate( size, alignment, true );
+  tracker_add( block, size, tag, file, line );
+  return block;
+} // -----------------------------------------------------------------------
+
+void* _memory_allocate_aligned_uninitialized( u64 size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_allocate_aligned_uninitialized called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  #ifdef FZY_CONFIG_DEBUG
+    if( !alignment || ( alignment & ( alignment - 1 ) ) )
+      FZY_ERROR( "memory_allocate_aligned_uninitialized :: alignment %llu is not a power of two", (unsigned long long)alignment );
+  #endif
+
+  if( !track_allocation( size, tag ) ) return 0;
+
+  void* block = allocate( size, alignment, false );
+  tracker_add( block, size, tag, file, line );
+  return block;
+} // -----------------------------------------------------------------------
+
+void memory_delete_aligned( void *block, u64 size, u64 alignment, fzy_memory_tag tag )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_delete_aligned called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  track_free( size, tag );
+  tracker_remove( block, size );
+  delete( block, alignment );
+} // -----------------------------------------------------------------------
+
+void* _memory_reallocate_aligned( void* block, u64 old_size, u64 new_size, u64 alignment, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_reallocate_aligned called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  // the old block is left untouched when the growth is refused
+  if( !track_reallocation( old_size, new_size, tag ) ) return 0;
+  tracker_remove( block, old_size );
+
+  void* new_block = reallocate( block, old_size, new_size, alignment );
+  tracker_add( new_block, new_size, tag, file, line );
+  return new_block;
+} // -----------------------------------------------------------------------
+
+void memory_thread_shutdown( void )
+{
+  memory_stack_destroy( &scratch );
+  cache_flush();
+} // -----------------------------------------------------------------------
+
+u64 memory_page_size( void )
+{
+  static u64 page_size = 0;
+  if( !page_size )
+  {
+    #ifdef FZY_PLATFORM_WINDOWS
+      SYSTEM_INFO info;
+      GetSystemInfo( &info );
+      page_size = info.dwPageSize;
+    #else
+      page_size = (u64)sysconf( _SC_PAGESIZE );
+    #endif
+  }
+  return page_size;
+} // -----------------------------------------------------------------------
+
+u64 memory_huge_page_size( void )
+{
+  static u64 huge_page_size = 0;
+  if( !huge_page_size )
+  {
+    #ifdef FZY_PLATFORM_WINDOWS
+      huge_page_size = (u64)GetLargePageMinimum();
+    #endif
+    // 2 MiB is the default huge page on x86-64 and on arm64 with 4 KiB pages
+    if( !huge_page_size ) huge_page_size = 2 * 1024 * 1024;
+  }
+  return huge_page_size;
+} // -----------------------------------------------------------------------
+
+void* _memory_allocate_huge( u64 size, fzy_memory_tag tag, const char* file, u32 line )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_allocate_huge called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  if( !wants_huge_pages( size ) )
+    return _memory_allocate_aligned( size, memory_page_size(), tag, file, line );
+
+  u64 huge = memory_huge_page_size();
+  u64 mapped = ( size + ( huge - 1 ) ) & ~( huge - 1 );
+  if( !track_allocation( mapped, tag ) ) return 0;
+
+  huge_page_kind kind;
+  void* block = map_huge( mapped, &kind );
+  if( !block )
+  {
+    track_free( mapped, tag );
+    return 0;
+  }
+
+  // only count blocks the registry holds, memory_delete_huge can't take the others back off
+  if( kind != HUGE_PAGES_NONE )
+  {
+    if( huge_block_add( block ) )
+      atomic_u64_add( &stats.huge_allocations[ tag ], mapped );
+    else
+      FZY_WARNING( "memory_allocate_huge :: all %u huge block slots are in use, the block is left out of the huge page statistics",
+                   HUGE_BLOCK_SLOTS );
+  }
+  tracker_add( block, size, tag, file, line );
+  return block;
+} // -----------------------------------------------------------------------
+
+void memory_delete_huge( void* block, u64 size, fzy_memory_tag tag )
+{
+  if( !block ) return;
+  if( !wants_huge_pages( size ) )
+  {
+    memory_delete_aligned( block, size, memory_page_size(), tag );
+    return;
+  }
+
+  u64 huge = memory_huge_page_size();
+  u64 mapped = ( size + ( huge - 1 ) ) & ~( huge - 1 );
+  if( huge_block_remove( block ) )
+    atomic_u64_sub( &stats.huge_allocations[ tag ], mapped );
+
+  track_free( mapped, tag );
+  tracker_remove( block, size );
+  unmap_huge( block, mapped );
+} // -----------------------------------------------------------------------
+
+i32 memory_compare( void* add1, void *add2, u64 size )
+{
+  return memcmp( add1, add2, size );
+} // ----------------------------------------------------------------------
+
+void* memory_zero( void *block, u64 size )
+{
+  return memset( block, 0, size );
+} // -----------------------------------------------------------------------
+
+void* memory_copy( void *dest, const void *source, u64 size )
+{
+  return memcpy( dest, source, size );
+} // -----------------------------------------------------------------------
+
+void* memory_move( void *dest, const void *source, u64 size )
+{
+  return memmove( dest, source, size );
+} // -----------------------------------------------------------------------
+
+void *memory_set( void *dest, i32 value, u64 size )
+{
+  return memset( dest, value, size );
+} // -----------------------------------------------------------------------
+
+void* memory_frame_allocate( u64 size, fzy_memory_tag tag )
+{
+  if( tag == MEM_TAG_UNKNOWN )
+    FZY_WARNING( "memory_frame_allocate called using MEM_TAG_UNKNOWN.  Re-class this allocation." );
+
+  // every block is a multiple of the alignment, so bumping the offset keeps the next block aligned
+  u64 aligned_size = ( size + ( ARENA_ALIGNMENT - 1 ) ) & ~(u64)( ARENA_ALIGNMENT - 1 );
+
+  // only move the offset when the block fits, a failed request leaves the rest of the arena usable
+  u64 start = atomic_u64_load( &frame.offset );
+  u64 end;
+  do
+  {
+    if( !frame.memory || size > frame.capacity || aligned_size > frame.capacity - start )
+    {
+      FZY_WARNING( "memory_frame_allocate :: frame arena exhausted, requested %llu bytes", (unsigned long long)size );
+      return 0;
+    }
+    end = start + aligned_size;
+  } while( !atomic_u64_compare_exchange( &frame.offset, &start, end ) );
+
+  u64 high_water = atomic_u64_load( &frame.high_water );
+  while( end > high_water && !atomic_u64_compare_exchange( &frame.high_water, &high_water, end ) ) {}
+
+  atomic_u64_add( &stats.frame_allocations[ tag ], size );
+  return frame.memory + start;
+} // -----------------------------------------------------------------------
+
+u64 memory_frame_high_water( void )
+{
+  return atomic_u64_load( &frame.high_water );
+} // -----------------------------------------------------------------------
+
+void memory_frame_reset( void )
+{
+  atomic_u64_store( &frame.offset, 0 );
+  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+    atomic_u64_store( &stats.frame_allocations[ i ], 0 );
+
+  // deliver the budget events latched this frame, listeners are free to allocate from here
+  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+  {
+    budget_fire( &soft_crossings[ i ], FZY_EVENT_CODE_MEMORY_SOFT_BUDGET, (fzy_memory_tag)i );
+    budget_fire( &hard_crossings[ i ], FZY_EVENT_CODE_MEMORY_HARD_BUDGET, (fzy_memory_tag)i );
+  }
+} // -----------------------------------------------------------------------
+
+b8 virtual_arena_create( virtual_arena* arena, u64 reserve_size, fzy_memory_tag tag )
+{
+  if( !arena ) return false;
+
+  u64 page = memory_page_size();
+  reserve_size = ( reserve_size + ( page - 1 ) ) & ~( page - 1 );
+
+  arena->huge_pages = false;
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    // large pages can not be reserved and committed separately, windows arenas use regular pages
+    void* base = VirtualAlloc( 0, reserve_size, MEM_RESERVE, PAGE_NOACCESS );
+    if( !base ) return false;
+  #else
+    void* base = 0;
+    if( wants_huge_pages( reserve_size ) )
+    {
+      u64 huge = memory_huge_page_size();
+      reserve_size = ( reserve_size + ( huge - 1 ) ) & ~( huge - 1 );
+      base = map_aligned( reserve_size, huge, PROT_NONE, MAP_NORESERVE );
+      if( !base ) return false;
+      #ifdef MADV_HUGEPAGE
+        arena->huge_pages = madvise( base, reserve_size, MADV_HUGEPAGE ) == 0;
+      #endif
+    }
+    else
+    {
+      base = mmap( 0, reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+      if( base == MAP_FAILED ) return false;
+    }
+  #endif
+
+  arena->base = base;
+  arena->reserved = reserve_size;
+  arena->committed = 0;
+  arena->used = 0;
+  arena->tag = tag;
+  return true;
+} // -----------------------------------------------------------------------
+
+void virtual_arena_destroy( virtual_arena* arena )
+{
+  if( !arena || !arena->base ) return;
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    VirtualFree( arena->base, 0, MEM_RELEASE );
+  #else
+    munmap( arena->base, arena->reserved );
+  #endif
+
+  track_free( arena->committed, arena->tag );
+  if( arena->huge_pages ) atomic_u64_sub( &stats.huge_allocations[ arena->tag ], arena->committed );
+  arena->base = 0;
+  arena->reserved = 0;
+  arena->committed = 0;
+  arena->used = 0;
+} // -----------------------------------------------------------------------
+
+b8 virtual_arena_commit( virtual_arena* arena, u64 size )
+{
+  if( size <= arena->committed ) return true;
+  if( size > arena->reserved ) return false;
+
+  // huge pages can only back whole huge pages of read/write memory
+  u64 granularity = arena->huge_pages ? memory_huge_page_size() : VIRTUAL_COMMIT_GRANULARITY;
+  u64 commit = ( size + ( granularity - 1 ) ) & ~( granularity - 1 );
+  if( commit > arena->reserved ) commit = arena->reserved;
+
+  u8* start = arena->base + arena->committed;
+  u64 length = commit - arena->committed;
+
+  #ifdef FZY_PLATFORM_WINDOWS
+    if( !VirtualAlloc( start, length, MEM_COMMIT, PAGE_READWRITE ) ) return false;
+  #else
+    if( mprotect( start, length, PROT_READ | PROT_WRITE ) != 0 ) return false;
+  #endif
+
+  if( !track_allocation( length, arena->tag ) )
+  {
+    #ifdef FZY_PLATFORM_WINDOWS
+      VirtualFree( start, length, MEM_DECOMMIT );
+    #else
+      mprotect( start, length, PROT_NONE );
+    #endif
+    return false;
+  }
+  if( arena->huge_pages ) atomic_u64_add( &stats.huge_allocations[ arena->tag ], length );
+  arena->committed = commit;
+  return true;
+} // -----------------------------------------------------------------------
+
+void* virtual_arena_push( virtual_arena* arena, u64 size )
+{
+  u64 start = ( arena->used + ( ARENA_ALIGNMENT - 1 ) ) & ~(u64)( ARENA_ALIGNMENT - 1 );
+  if( !virtual_arena_commit( arena, start + size ) )
+  {
+    FZY_WARNING( "virtual_arena_push :: failed to commit %llu bytes of a %llu byte reservation", (unsigned long long)( start + size ), (unsigned long long)arena->reserved );
+    return 0;
+  }
+  arena->used = start + size;
+  return arena->base + start;
+} // -----------------------------------------------------------------------
+
+void virtual_arena_reset( virtual_arena* arena )
+{
+  arena->used = 0;
+} // -----------------------------------------------------------------------
+
+b8 memory_stack_create( memory_stack* stack, u64 size, fzy_memory_tag tag )
+{
+  if( !stack ) return false;
+
+  size = ( size + ( ARENA_ALIGNMENT - 1 ) ) & ~(u64)( ARENA_ALIGNMENT - 1 );
+  stack->memory = memory_allocate_aligned_uninitialized( size, ARENA_ALIGNMENT, tag );
+  if( !stack->memory ) return false;
+
+  stack->capacity = size;
+  stack->bottom = 0;
+  stack->top = size;
+  stack->tag = tag;
+  stack->owns_memory = true;
+  return true;
+} // -----------------------------------------------------------------------
+
+b8 memory_stack_create_from_buffer( memory_stack* stack, void* buffer, u64 size )
+{
+  if( !stack || !buffer ) return false;
+
+  #ifdef FZY_CONFIG_DEBUG
+    if( (u64)buffer & ( ARENA_ALIGNMENT - 1 ) )
+      FZY_ERROR( "memory_stack_create_from_buffer :: buffer is not aligned to %u bytes", ARENA_ALIGNMENT );
+  #endif
+
+  // only whole aligned blocks can be handed out from the top
+  size &= ~(u64)( ARENA_ALIGNMENT - 1 );
+  stack->memory = buffer;
+  stack->capacity = size;
+  stack->bottom = 0;
+  stack->top = size;
+  stack->tag = MEM_TAG_UNKNOWN;
+  stack->owns_memory = false;
+  return true;
+} // -----------------------------------------------------------------------
+
+void memory_stack_destroy( memory_stack* stack )
+{
+  if( !stack || !stack->memory ) return;
+
+  if( stack->owns_memory )
+    memory_delete_aligned( stack->memory, stack->capacity, ARENA_ALIGNMENT, stack->tag );
+  stack->memory = 0;
+  stack->capacity = 0;
+  stack->bottom = 0;
+  stack->top = 0;
+} // -----------------------------------------------------------------------
+
+void* memory_stack_allocate( memory_stack* stack, u64 size )
+{
+  u64 start = ( stack->bottom + ( ARENA_ALIGNMENT - 1 ) ) & ~(u64)( ARENA_ALIGNMENT - 1 );
+  if( size > stack->top || start > stack->top - size )
+  {
+    FZY_WARNING( "memory_stack_allocate :: stack of %llu bytes exhausted, requested %llu bytes",
+                 (unsigned long long)stack->capacity, (unsigned long long)size );
+    return 0;
+  }
+  stack->bottom = start + size;
+  return stack->memory + start;
+} // -----------------------------------------------------------------------
+
+void* memory_stack_allocate_top( memory_stack* stack, u64 size )
+{
+  if( size > stack->top )
+  {
+    FZY_WARNING( "memory_stack_allocate_top :: stack of %llu bytes exhausted, requested %llu bytes",
+                 (unsigned long long)stack->capacity, (unsigned long long)size );
+    return 0;
+  }
+
+  u64 start = ( stack->top - size ) & ~(u64)( ARENA_ALIGNMENT - 1 );
+  if( start < stack->bottom )
+  {
+    FZY_WARNING( "memory_stack_allocate_top :: stack of %llu bytes exhausted, requested %llu bytes",
+                 (unsigned long long)stack->capacity, (unsigned long long)size );
+    return 0;
+  }
+  stack->top = start;
+  return stack->memory + start;
+} // -----------------------------------------------------------------------
+
+memory_stack_marker memory_stack_get_marker( memory_stack* stack )
+{
+  return stack->bottom;
+} // -----------------------------------------------------------------------
+
+memory_stack_marker memory_stack_get_marker_top( memory_stack* stack )
+{
+  return stack->top;
+} // -----------------------------------------------------------------------
+
+void memory_stack_free_to_marker( memory_stack* stack, memory_stack_marker marker )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( marker > stack->bottom ) FZY_ERROR( "memory_stack_free_to_marker :: marker is above the bottom of the stack" );
+  #endif
+  stack->bottom = marker;
+} // -----------------------------------------------------------------------
+
+void memory_stack_free_to_marker_top( memory_stack* stack, memory_stack_marker marker )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( marker < stack->top || marker > stack->capacity )
+      FZY_ERROR( "memory_stack_free_to_marker_top :: marker is below the top of the stack" );
+  #endif
+  stack->top = marker;
+} // -----------------------------------------------------------------------
+
+memory_stack* memory_scratch_stack( void )
+{
+  if( !scratch.memory && !memory_stack_create( &scratch, FZY_SCRATCH_STACK_SIZE, MEM_TAG_SCRATCH ) )
+    return 0;
+  return &scratch;
+} // -----------------------------------------------------------------------
+
+static void* heap_allocate( void* context, u64 size, const char* file, u32 line )
+{
+  return _memory_allocate_uninitialized( size, (fzy_memory_tag)(u64)context, file, line );
+} // -----------------------------------------------------------------------
+
+static void* heap_reallocate( void* context, void* block, u64 old_size, u64 new_size, const char* file, u32 line )
+{
+  return _memory_reallocate( block, old_size, new_size, (fzy_memory_tag)(u64)context, file, line );
+} // -----------------------------------------------------------------------
+
+static void heap_free( void* context, void* block, u64 size )
+{
+  memory_delete( block, size, (fzy_memory_tag)(u64)context );
+} // -----------------------------------------------------------------------
+
+static void* frame_allocate( void* context, u64 size, const char* file, u32 line )
+{
+  // the frame arena is not tracked per call site
+  (void)file;
+  (void)line;
+  return memory_frame_allocate( size, (fzy_memory_tag)(u64)context );
+} // -----------------------------------------------------------------------
+
+static void* frame_reallocate( void* context, void* block, u64 old_size, u64 new_size, const char* file, u32 line )
+{
+  (void)file;
+  (void)line;
+  void* new_block = memory_frame_allocate( new_size, (fzy_memory_tag)(u64)context );
+  if( new_block && block ) memory_copy( new_block, block, old_size < new_size ? old_size : new_size );
+  return new_block;
+} // -----------------------------------------------------------------------
+
+static void no_free( void* context, void* block, u64 size )
+{
+  (void)context;
+  (void)block;
+  (void)size;
+} // -----------------------------------------------------------------------
+
+static void* stack_allocate( void* context, u64 size, const char* file, u32 line )
+{
+  (void)file;
+  (void)line;
+  return memory_stack_allocate( (memory_stack*)context, size );
+} // -----------------------------------------------------------------------
+
+static void* stack_reallocate( void* context, void* block, u64 old_size, u64 new_size, const char* file, u32 line )
+{
+  (void)file;
+  (void)line;
+  memory_stack* stack = context;
+
+  // the most recent block can grow or shrink in place
+  if( block && (u8*)block + old_size == stack->memory + stack->bottom )
+  {
+    u64 start = (u8*)block - stack->memory;
+    if( new_size <= stack->top - start )
+    {
+      stack->bottom = start + new_size;
+      return block;
+    }
+  }
+
+  void* new_block = memory_stack_allocate( stack, new_size );
+  if( new_block && block ) memory_copy( new_block, block, old_size < new_size ? old_size : new_size );
+  return new_block;
+} // -----------------------------------------------------------------------
+
+static void* pool_allocate( void* context, u64 size, const char* file, u32 line )
+{
+  (void)file;
+  (void)line;
+  memory_pool* pool = context;
+  if( size > pool->block_size )
+  {
+    FZY_WARNING( "memory_allocator_pool :: %llu bytes requested from a pool of %llu byte blocks",
+                 (unsigned long long)size, (unsigned long long)pool->block_size );
+    return 0;
+  }
+  return memory_pool_allocate( pool, false );
+} // -----------------------------------------------------------------------
+
+static void* pool_reallocate( void* context, void* block, u64 old_size, u64 new_size, const char* file, u32 line )
+{
+  (void)old_size;
+  if( !block ) return pool_allocate( context, new_size, file, line );
+
+  memory_pool* pool = context;
+  if( new_size > pool->block_size )
+  {
+    FZY_WARNING( "memory_allocator_pool :: %llu bytes requested from a pool of %llu byte blocks",
+                 (unsigned long long)new_size, (unsigned long long)pool->block_size );
+    return 0;
+  }
+  return block;
+} // -----------------------------------------------------------------------
+
+static void pool_free( void* context, void* block, u64 size )
+{
+  (void)size;
+  memory_pool_free( (memory_pool*)context, block );
+} // -----------------------------------------------------------------------
+
+memory_allocator memory_allocator_heap( fzy_memory_tag tag )
+{
+  memory_allocator allocator = { heap_allocate, heap_reallocate, heap_free, (void*)(u64)tag };
+  return allocator;
+} // -----------------------------------------------------------------------
+
+memory_allocator memory_allocator_frame( fzy_memory_tag tag )
+{
+  memory_allocator allocator = { frame_allocate, frame_reallocate, no_free, (void*)(u64)tag };
+  return allocator;
+} // -----------------------------------------------------------------------
+
+memory_allocator memory_allocator_stack( memory_stack* stack )
+{
+  memory_allocator allocator = { stack_allocate, stack_reallocate, no_free, stack };
+  return allocator;
+} // -----------------------------------------------------------------------
+
+memory_allocator memory_allocator_pool( memory_pool* pool )
+{
+  memory_allocator allocator = { pool_allocate, pool_reallocate, pool_free, pool };
+  return allocator;
+} // -----------------------------------------------------------------------
+
+static b8 pool_grow( memory_pool* pool )
+{
+  u64 chunk_size = sizeof( pool_chunk ) + pool->block_size * pool->blocks_per_chunk;
+  pool_chunk* chunk = pool->allocator.allocate( pool->allocator.context, chunk_size, pool->file, pool->line );
+  if( !chunk ) return false;
+
+  chunk->next = pool->chunks;
+  pool->chunks = chunk;
+
+  // thread the new blocks onto the free list, first block is handed out first
+  u8* blocks = (u8*)( chunk + 1 );
+  for( i64 i = (i64)pool->blocks_per_chunk - 1; i >= 0; i-- )
+  {
+    pool_block* block = (pool_block*)( blocks + i * pool->block_size );
+    block->next = pool->free_list;
+    pool->free_list = block;
+  }
+  pool->capacity += pool->blocks_per_chunk;
+  return true;
+} // -----------------------------------------------------------------------
+
+memory_pool* _memory_pool_create( u64 block_size, u32 blocks_per_chunk, fzy_memory_tag tag, const char* file, u32 line )
+{
+  memory_allocator allocator = memory_allocator_heap( tag );
+  return _memory_pool_create_with_allocator( block_size, blocks_per_chunk, &allocator, file, line );
+} // -----------------------------------------------------------------------
+
+memory_pool* _memory_pool_create_with_allocator( u64 block_size, u32 blocks_per_chunk, const memory_allocator* allocator,
+                                                 const char* file, u32 line )
+{
+  memory_pool* pool = allocator->allocate( allocator->context, sizeof( struct memory_pool ), file, line );
+  if( !pool ) return 0;
+
+  // every block must be able to hold the free list link and stay pointer aligned
+  if( block_size < sizeof( pool_block ) ) block_size = sizeof( pool_block );
+  pool->block_size = ( block_size + ( sizeof( void* ) - 1 ) ) & ~(u64)( sizeof( void* ) - 1 );
+  pool->blocks_per_chunk = blocks_per_chunk ? blocks_per_chunk : 1;
+  pool->chunks = 0;
+  pool->free_list = 0;
+  pool->capacity = 0;
+  pool->used = 0;
+  pool->peak = 0;
+  pool->allocator = *allocator;
+  pool->file = file;
+  pool->line = line;
+  return pool;
+} // -----------------------------------------------------------------------
+
+void memory_pool_destroy( memory_pool* pool )
+{
+  if( !pool ) return;
+
+  u64 chunk_size = sizeof( pool_chunk ) + pool->block_size * pool->blocks_per_chunk;
+  pool_chunk* chunk = pool->chunks;
+  while( chunk )
+  {
+    pool_chunk* next = chunk->next;
+    pool->allocator.free( pool->allocator.context, chunk, chunk_size );
+    chunk = next;
+  }
+  memory_allocator allocator = pool->allocator;
+  allocator.free( allocator.context, pool, sizeof( struct memory_pool ) );
+} // -----------------------------------------------------------------------
+
+void* memory_pool_allocate( memory_pool* pool, b8 zero )
+{
+  if( !pool->free_list && !pool_grow( pool ) )
+  {
+    FZY_ERROR( "memory_pool_allocate :: failed to grow the pool." );
+    return 0;
+  }
+
+  pool_block* block = pool->free_list;
+  pool->free_list = block->next;
+
+  pool->used++;
+  if( pool->used > pool->peak )
+    pool->peak = pool->used;
+
+  if( zero ) memory_zero( block, pool->block_size );
+  return block;
+} // -----------------------------------------------------------------------
+
+void memory_pool_free( memory_pool* pool, void* block )
+{
+  if( !block ) return;
+  #ifdef FZY_CONFIG_DEBUG
+    if( pool->used == 0 ) FZY_ERROR( "memory_pool_free :: freeing more blocks than allocated." );
+  #endif
+
+  pool_block* b = (pool_block*)block;
+  b->next = pool->free_list;
+  pool->free_list = b;
+  pool->used--;
+} // -----------------------------------------------------------------------
+
+memory_pool_stats memory_pool_get_stats( memory_pool* pool )
+{
+  memory_pool_stats out;
+  out.block_size = pool->block_size;
+  out.capacity = pool->capacity;
+  out.used = pool->used;
+  out.peak = pool->peak;
+  return out;
+} // -----------------------------------------------------------------------
+
+char* memory_get_usage_str( )
+{
+  text_buffer text = { 0 };
+  f32 amount = 0.0f;
+  const char* unit = 0;
+
+  text_append( &text, "System memory usage (tagged):\n" );
+  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+  {
+    unit = format_size( atomic_u64_load( &stats.tagged_allocations[ i ] ), &amount );
+    text_append( &text, "  %s: %.2f%s", memory_tag_strings[ i ], amount, unit );
+    if( budgets[ i ].soft )
+    {
+      unit = format_size( budgets[ i ].soft, &amount );
+      text_append( &text, "  soft %.2f%s", amount, unit );
+    }
+    if( budgets[ i ].hard )
+    {
+      unit = format_size( budgets[ i ].hard, &amount );
+      text_append( &text, "  hard %.2f%s", amount, unit );
+    }
+    text_append( &text, "\n" );
+  }
+
+  text_append( &text, "Huge page backed (tagged):\n" );
+  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+  {
+    u64 bytes = atomic_u64_load( &stats.huge_allocations[ i ] );
+    if( !bytes ) continue;
+    unit = format_size( bytes, &amount );
+    text_append( &text, "  %s: %.2f%s\n", memory_tag_strings[ i ], amount, unit );
+  }
+
+  unit = format_size( atomic_u64_load( &frame.high_water ), &amount );
+  text_append( &text, "Frame arena usage (tagged), high-water %.2f%s, huge pages %s:\n", amount, unit,
+               huge_page_kind_strings[ frame.huge_pages ] );
+  for( u32 i = 0; i < MEM_TAG_MAX_TAGS; i++ )
+  {
+    u64 bytes = atomic_u64_load( &stats.frame_allocations[ i ] );
+    if( !bytes ) continue;
+    unit = format_size( bytes, &amount );
+    text_append( &text, "  %s: %.2f%s\n", memory_tag_strings[ i ], amount, unit );
+  }
+
+  return text_finish( &text );
+} // -----------------------------------------------------------------------
+
+void memory_set_budget( fzy_memory_tag tag, u64 soft_limit, u64 hard_limit )
+{
+  if( soft_limit && hard_limit && soft_limit > hard_limit )
+    FZY_WARNING( "memory_set_budget :: soft budget for %s is above its hard budget", memory_tag_strings[ tag ] );
+
+  budgets[ tag ].soft = soft_limit;
+  budgets[ tag ].hard = hard_limit;
+} // -----------------------------------------------------------------------
+
+u64 memory_get_tag_usage( fzy_memory_tag tag )
+{
+  return atomic_u64_load( &stats.tagged_allocations[ tag ] );
+} // -----------------------------------------------------------------------
+
+void memory_tracking_enable( b8 enable )
+{
+  tracker.enabled = enable;
+} // -----------------------------------------------------------------------
+
+u64 memory_report_leaks( void )
+{
+  memory_snapshot* snapshot = snapshot_collect();
+  if( !snapshot ) return 0;
+
+  u64 leaks = 0;
+  for( u64 i = 0; i < snapshot->count; i++ )
+    leaks += snapshot->sites[ i ].count;
+
+  if( leaks )
+  {
+    qsort( snapshot->sites, snapshot->count, sizeof( allocation_site ), site_compare_bytes );
+    FZY_WARNING( "memory_report_leaks :: %llu allocations are still live", (unsigned long long)leaks );
+    for( u64 i = 0; i < snapshot->count; i++ )
+    {
+      allocation_site* site = &snapshot->sites[ i ];
+      FZY_WARNING( "  %s:%u %s %lld bytes in %lld blocks", site->file, site->line,
+                   memory_tag_strings[ site->tag ], (long long)site->bytes, (long long)site->count );
+    }
+  }
+
+  memory_snapshot_destroy( snapshot );
+  return leaks;
+} // -----------------------------------------------------------------------
+
+memory_snapshot* memory_snapshot_take( void )
+{
+  if( !tracker.enabled )
+    FZY_WARNING( "memory_snapshot_take :: allocation tracking is disabled, the snapshot will be empty." );
+
+  return snapshot_collect();
+} // -----------------------------------------------------------------------
+
+void memory_snapshot_destroy( memory_snapshot* snapshot )
+{
+  if( !snapshot ) return;
+  free( snapshot->sites );
+  free( snapshot );
+} // -----------------------------------------------------------------------
+
+char* memory_snapshot_diff_str( memory_snapshot* before, memory_snapshot* after )
+{
+  text_buffer text = { 0 };
+  u64 capacity = before->count + after->count;
+  allocation_site* changes = capacity ? malloc( capacity * sizeof( allocation_site ) ) : 0;
+  u64 count = 0;
+  i64 total = 0;
+
+  // both snapshots are sorted by call site, walk them together
+  u64 b = 0, a = 0;
+  while( changes && ( b < before->count || a < after->count ) )
+  {
+    i32 order = b == before->count ? 1 : a == after->count ? -1 :
+                site_compare( &before->sites[ b ], &after->sites[ a ] );
+
+    allocation_site change;
+    if( order < 0 )
+    {
+      change = before->sites[ b++ ];
+      change.count = -change.count;
+      change.bytes = -change.bytes;
+    }
+    else if( order > 0 )
+    {
+      change = after->sites[ a++ ];
+    }
+    else
+    {
+      change = after->sites[ a ];
+      change.count -= before->sites[ b ].count;
+      change.bytes -= before->sites[ b ].bytes;
+      a++;
+      b++;
+    }
+
+    if( change.count || change.bytes )
+    {
+      changes[ count++ ] = change;
+      total += change.bytes;
+    }
+  }
+
+  text_append( &text, "Memory change between snapshots: %lld bytes at %llu call sites\n", (long long)total, (unsigned long long)count );
+  if( count )
+  {
+    qsort( changes, count, sizeof( allocation_site ), site_compare_bytes );
+    for( u64 i = 0; i < count; i++ )
+    {
+      text_append( &text, "  %+lld bytes %+lld blocks  %s %s:%u\n", (long long)changes[ i ].bytes, (long long)changes[ i ].count,
+                   memory_tag_strings[ changes[ i ].tag ], changes[ i ].file, changes[ i ].line );
+    }
+  }
+
+  free( changes );
+  return text_finish( &text );
 } // -----------------------------------------------------------------------
@@ -0,0 +1,145 @@
+#include "core/fzy_mpmc_queue.h"
+
+#include "core/fzy_atomic.h"
+#include "core/fzy_logger.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief Represents a mpmc queue ( Vyukov's bounded queue ).  A slot whose sequence equals a
+    producer's position is free for that producer, a slot whose sequence equals a consumer's
+    position + 1 holds that consumer's element.  After a pop the sequence jumps a full lap ahead
+*/
+typedef struct mpmc_queue
+{
+  // claimed by producers
+  volatile u64 enqueue_pos;
+  u8 enqueue_pad[ MEMORY_ALIGNMENT_CACHE_LINE - sizeof( u64 ) ];
+
+  // claimed by consumers
+  volatile u64 dequeue_pos;
+  u8 dequeue_pad[ MEMORY_ALIGNMENT_CACHE_LINE - sizeof( u64 ) ];
+
+  // read only after creation
+  u8* cells;              // capacity cells of stride bytes, each a u64 sequence then the element
+  u64 mask;
+  u64 stride;
+  u32 capacity;
+  u32 type_size;
+  u8 memory_tag;
+
+} mpmc_queue;
+// ---------------------------------------------------------------------------
+
+static inline volatile u64* cell_sequence( mpmc_queue* queue, u64 pos )
+{
+  return (volatile u64*)( queue->cells + ( pos & queue->mask ) * queue->stride );
+} // ---------------------------------------------------------------------------
+
+static inline u8* cell_data( mpmc_queue* queue, u64 pos )
+{
+  return queue->cells + ( pos & queue->mask ) * queue->stride + sizeof( u64 );
+} // ---------------------------------------------------------------------------
+
+mpmc_queue* _mpmc_queue_create( u32 type_size, u32 capacity, u8 memory_tag )
+{
+  // at least two slots, with one a pushed sequence would equal the next lap's free sequence
+  u32 rounded = 2;
+  while( rounded < capacity && rounded < 0x80000000u ) rounded <<= 1;
+
+  mpmc_queue* queue = memory_allocate_aligned( sizeof( struct mpmc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+  if( !queue ) return 0;
+
+  // keeps every sequence 8 byte aligned
+  u64 stride = ( sizeof( u64 ) + type_size + 7 ) & ~7ull;
+  queue->cells = memory_allocate_aligned_uninitialized( stride * rounded, MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+  if( !queue->cells )
+  {
+    memory_delete_aligned( queue, sizeof( struct mpmc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+    return 0;
+  }
+
+  queue->enqueue_pos = 0;
+  queue->dequeue_pos = 0;
+  queue->mask = rounded - 1;
+  queue->stride = stride;
+  queue->capacity = rounded;
+  queue->type_size = type_size;
+  queue->memory_tag = memory_tag;
+
+  for( u64 i = 0; i < rounded; i++ )
+    *cell_sequence( queue, i ) = i;
+  return queue;
+} // ---------------------------------------------------------------------------
+
+void mpmc_queue_destroy( mpmc_queue* queue )
+{
+  if( !queue ) return;
+
+  u8 tag = queue->memory_tag;
+  memory_delete_aligned( queue->cells, queue->stride * queue->capacity, MEMORY_ALIGNMENT_CACHE_LINE, tag );
+  memory_delete_aligned( queue, sizeof( struct mpmc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, tag );
+} // ---------------------------------------------------------------------------
+
+b8 mpmc_queue_push( mpmc_queue* queue, const void* data )
+{
+  u64 pos = atomic_u64_load( &queue->enqueue_pos );
+  for( ;; )
+  {
+    i64 diff = (i64)( atomic_u64_load( cell_sequence( queue, pos ) ) - pos );
+    if( diff == 0 )
+    {
+      // the slot is free, claim it. On failure pos holds the current position
+      if( atomic_u64_compare_exchange( &queue->enqueue_pos, &pos, pos + 1 ) ) break;
+    }
+    else if( diff < 0 )
+    {
+      return false; // a lap behind, the queue is full
+    }
+    else
+    {
+      pos = atomic_u64_load( &queue->enqueue_pos ); // another producer took the slot
+    }
+  }
+
+  memory_copy( cell_data( queue, pos ), data, queue->type_size );
+  atomic_u64_store( cell_sequence( queue, pos ), pos + 1 );   // publishes the element
+  return true;
+} // ---------------------------------------------------------------------------
+
+b8 mpmc_queue_pop( mpmc_queue* queue, void* out )
+{
+  u64 pos = atomic_u64_load( &queue->dequeue_pos );
+  for( ;; )
+  {
+    i64 diff = (i64)( atomic_u64_load( cell_sequence( queue, pos ) ) - ( pos + 1 ) );
+    if( diff == 0 )
+    {
+      // the slot holds an element, claim it. On failure pos holds the current position
+      if( atomic_u64_compare_exchange( &queue->dequeue_pos, &pos, pos + 1 ) ) break;
+    }
+    else if( diff < 0 )
+    {
+      return false; // nothing published yet, the queue is empty
+    }
+    else
+    {
+      pos = atomic_u64_load( &queue->dequeue_pos ); // another consumer took the slot
+    }
+  }
+
+  memory_copy( out, cell_data( queue, pos ), queue->type_size );
+  atomic_u64_store( cell_sequence( queue, pos ), pos + queue->mask + 1 );   // frees the slot for the next lap
+  return true;
+} // ---------------------------------------------------------------------------
+
+u32 mpmc_queue_size( mpmc_queue* queue )
+{
+  u64 dequeue = atomic_u64_load( &queue->dequeue_pos );
+  u64 enqueue = atomic_u64_load( &queue->enqueue_pos );
+  return enqueue > dequeue ? (u32)( enqueue - dequeue ) : 0;
+} // ---------------------------------------------------------------------------
+
+u32 mpmc_queue_capacity( mpmc_queue* queue )
+{
+  return queue->capacity;
+} // ---------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+#include "core/fzy_name.h"
+
+#include "core/fzy_hashmap.h"
+#include "core/fzy_logger.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_string.h"
+
+/* @brief A block of interned text, blocks are chained and never move */
+typedef struct name_block
+{
+  struct name_block* next;
+  u64 used;
+  u64 capacity;
+  // text follows
+
+} name_block;
+
+typedef struct name_system_state
+{
+  hashmap* names;       // name_id -> const char*
+  name_block* blocks;   // head is the block being filled
+
+} name_system_state;
+
+// bytes of text per block, longer names get a block of their own
+#define NAME_BLOCK_SIZE 4096
+
+static name_system_state* state_ptr = 0;
+// ---------------------------------------------------------------------------
+
+// copies the text into the head block, starting a new block when it does not fit
+static const char* name_store( const char* str, u64 length )
+{
+  name_block* block = state_ptr->blocks;
+  if( !block || block->capacity - block->used < length + 1 )
+  {
+    u64 capacity = length + 1 > NAME_BLOCK_SIZE ? length + 1 : NAME_BLOCK_SIZE;
+    block = memory_allocate_uninitialized( sizeof( struct name_block ) + capacity, MEM_TAG_STRING );
+    block->used = 0;
+    block->capacity = capacity;
+    block->next = state_ptr->blocks;
+    state_ptr->blocks = block;
+  }
+
+  char* text = (char*)( block + 1 ) + block->used;
+  memory_copy( text, str, length + 1 );
+  block->used += length + 1;
+  return text;
+} // ---------------------------------------------------------------------------
+
+b8 name_system_initialize( void )
+{
+  if( state_ptr ) return false;
+
+  state_ptr = memory_allocate( sizeof( struct name_system_state ), MEM_TAG_STRING );
+  state_ptr->names = hashmap_create( const char*, 256, MEM_TAG_STRING );
+  state_ptr->blocks = 0;
+  FZY_INFO( "Name System initialized." );
+  return true;
+} // ---------------------------------------------------------------------------
+
+b8 name_system_shutdown( void )
+{
+  if( !state_ptr ) return false;
+
+  name_block* block = state_ptr->blocks;
+  while( block )
+  {
+    name_block* next = block->next;
+    memory_delete( block, sizeof( struct name_block ) + block->capacity, MEM_TAG_STRING );
+    block = next;
+  }
+
+  hashmap_destroy( state_ptr->names );
+  memory_delete( state_ptr, sizeof( struct name_system_state ), MEM_TAG_STRING );
+  state_ptr = 0;
+  return true;
+} // ---------------------------------------------------------------------------
+
+name_id name_hash( const char* str )
+{
+  u64 hash = FZY__NAME_BASIS;
+  while( *str )
+  {
+    hash ^= (u8)( *str++ );
+    hash *= FZY__NAME_PRIME;
+  }
+  return hash;
+} // ---------------------------------------------------------------------------
+
+name_id name_hash_view( string_view view )
+{
+  u64 hash = FZY__NAME_BASIS;
+  for( u64 i = 0; i < view.length; i++ )
+  {
+    hash ^= (u8)view.data[ i ];
+    hash *= FZY__NAME_PRIME;
+  }
+  return hash;
+} // ---------------------------------------------------------------------------
+
+name_id name_intern( const char* str )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( !state_ptr ) FZY_ERROR( "name_intern :: the name system is not initialized." );
+  #endif
+
+  name_id id = name_hash( str );
+  const char** existing = hashmap_get( const char*, state_ptr->names, id );
+  if( existing )
+  {
+    if( !string_is_equal( *existing, str ) )
+      FZY_ERROR( "name_intern :: [ %s ] and [ %s ] hash to the same id.", *existing, str );
+    return id;
+  }
+
+  const char* text = name_store( str, string_length( str ) );
+  hashmap_insert( state_ptr->names, id, &text );
+  return id;
+} // ---------------------------------------------------------------------------
+
+const char* name_string( name_id id )
+{
+  if( !state_ptr ) return 0;
+
+  const char** text = hashmap_get( const char*, state_ptr->names, id );
+  return text ? *text : 0;
+} // ---------------------------------------------------------------------------
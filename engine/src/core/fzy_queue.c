@@ -2,28 +2,91 @@
 #include "core/fzy_logger.h"
 #include "core/fzy_mem.h"
 
-queue* _queue_create( u32 type_size, u32 capacity, u8 memory_tag )
+// slot of the element offset places behind the front
+static inline u32 queue_slot( queue* queue, u32 offset )
 {
-  queue *q = memory_allocate( sizeof( struct queue ), memory_tag );
-  q->data = memory_allocate( type_size * capacity, memory_tag );
+  u32 slot = queue->front + offset;
+  return slot >= queue->capacity ? slot - queue->capacity : slot;
+} // ---------------------------------------------------------------------------
+
+// copies count elements starting at slot into out, in at most two copies
+static void queue_copy_out( queue* queue, u32 slot, void* out, u32 count )
+{
+  u32 first = queue->capacity - slot;
+  if( first > count ) first = count;
+
+  memory_copy( out, queue->data + (u64)slot * queue->type_size, (u64)first * queue->type_size );
+  if( count > first )
+    memory_copy( (u8*)out + (u64)first * queue->type_size, queue->data, (u64)( count - first ) * queue->type_size );
+} // ---------------------------------------------------------------------------
+
+// copies count elements from data into the queue starting at slot, in at most two copies
+static void queue_copy_in( queue* queue, u32 slot, const void* data, u32 count )
+{
+  u32 first = queue->capacity - slot;
+  if( first > count ) first = count;
+
+  memory_copy( queue->data + (u64)slot * queue->type_size, data, (u64)first * queue->type_size );
+  if( count > first )
+    memory_copy( queue->data, (const u8*)data + (u64)first * queue->type_size, (u64)( count - first ) * queue->type_size );
+} // ---------------------------------------------------------------------------
+
+// moves the elements into an array of at least capacity slots, unwrapping them so the front is slot 0
+static b8 queue_grow( queue* queue, u32 capacity )
+{
+  u32 new_capacity = queue->capacity ? queue->capacity : 8;
+  while( new_capacity < capacity )
+    new_capacity = new_capacity > 0x7fffffffu ? 0xffffffffu : new_capacity * 2;
+
+  u8* data = queue->allocator.allocate( queue->allocator.context, (u64)queue->type_size * new_capacity, queue->file, queue->line );
+  if( !data ) return false;
+
+  if( queue->count ) queue_copy_out( queue, queue->front, data, queue->count );
+  if( queue->data )
+    queue->allocator.free( queue->allocator.context, queue->data, (u64)queue->type_size * queue->capacity );
+
+  queue->data = data;
+  queue->front = 0;
+  queue->capacity = new_capacity;
+  return true;
+} // ---------------------------------------------------------------------------
+
+queue* _queue_create( u32 type_size, u32 capacity, u8 memory_tag, const char* file, u32 line )
+{
+  memory_allocator allocator = memory_allocator_heap( memory_tag );
+  return _queue_create_with_allocator( type_size, capacity, &allocator, file, line );
+} // ---------------------------------------------------------------------------
+
+queue* _queue_create_with_allocator( u32 type_size, u32 capacity, const memory_allocator* allocator, const char* file, u32 line )
+{
+  queue *q = allocator->allocate( allocator->context, sizeof( struct queue ), file, line );
+  if( !q ) return 0;
+  q->data = 0;
   q->front = 0;
-  q->rear = -1;
   q->count = 0;
-  q->capacity = capacity;
+  q->capacity = 0;
   q->type_size = type_size;
-  q->tag = memory_tag;
+  q->allocator = *allocator;
+  q->file = file;
+  q->line = line;
+  if( capacity && !queue_grow( q, capacity ) )
+  {
+    allocator->free( allocator->context, q, sizeof( struct queue ) );
+    return 0;
+  }
   return q;
 } // ---------------------------------------------------------------------------
 
 void queue_destroy( queue *queue )
 {
   if( !queue ) return;
+  memory_allocator allocator = queue->allocator;
   if( queue->data )
   {
-    memory_delete( queue->data, queue->type_size * queue->capacity, queue->tag );
+    allocator.free( allocator.context, queue->data, (u64)queue->type_size * queue->capacity );
     queue->data = 0;
   }
-  memory_delete( queue, sizeof( struct queue ), queue->tag );
+  allocator.free( allocator.context, queue, sizeof( struct queue ) );
   queue = 0;
 } // ---------------------------------------------------------------------------
 
@@ -32,37 +95,89 @@ b8 queue_is_empty( queue* queue )
   return !queue->count;
 } // ---------------------------------------------------------------------------
 
+u32 queue_size( queue* queue )
+{
+  return queue->count;
+} // ---------------------------------------------------------------------------
+
+b8 queue_reserve( queue* queue, u32 capacity )
+{
+  if( capacity <= queue->capacity ) return true;
+  return queue_grow( queue, capacity );
+} // ---------------------------------------------------------------------------
+
 void* queue_get_front( queue *queue )
 {
   if( queue_is_empty( queue ) )
     FZY_ERROR( "queue_get_front :: queue is empty" );
 
-  return &queue->data[ queue->front * queue->type_size ];
+  return &queue->data[ (u64)queue->front * queue->type_size ];
 } // ---------------------------------------------------------------------------
 
 void queue_push( queue* queue, const void* data )
 {
-  if( queue->count == queue->capacity )
+  if( queue->count == queue->capacity && !queue_grow( queue, queue->count + 1 ) )
   {
-    FZY_ERROR( "queue_push :: overflow" );
+    FZY_ERROR( "queue_push :: failed to grow the queue" );
     return;
   }
 
-  queue->rear = ( queue->rear + 1 ) % queue->capacity;
-  memory_copy( &queue->data[ queue->rear * queue->type_size ], data, queue->type_size );
+  u32 rear = queue_slot( queue, queue->count );
+  memory_copy( &queue->data[ (u64)rear * queue->type_size ], data, queue->type_size );
   queue->count++;
 } // ---------------------------------------------------------------------------
 
-void* queue_pop( queue* queue )
+b8 queue_push_n( queue *queue, const void* data, u32 count )
+{
+  if( count > queue->capacity - queue->count )
+  {
+    if( count > 0xffffffffu - queue->count || !queue_grow( queue, queue->count + count ) )
+      return false;
+  }
+  if( !count ) return true;
+
+  queue_copy_in( queue, queue_slot( queue, queue->count ), data, count );
+  queue->count += count;
+  return true;
+} // ---------------------------------------------------------------------------
+
+b8 queue_pop( queue* queue, void* out )
+{
+  if( queue_is_empty( queue ) ) return false;
+
+  if( out ) memory_copy( out, &queue->data[ (u64)queue->front * queue->type_size ], queue->type_size );
+  queue_consume( queue, 1 );
+  return true;
+} // ---------------------------------------------------------------------------
+
+u32 queue_pop_n( queue* queue, void* out, u32 count )
+{
+  if( count > queue->count ) count = queue->count;
+  if( !count ) return 0;
+
+  if( out ) queue_copy_out( queue, queue->front, out, count );
+  queue_consume( queue, count );
+  return count;
+} // ---------------------------------------------------------------------------
+
+void* queue_peek_span( queue* queue, u32* count )
 {
   if( queue_is_empty( queue ) )
   {
-    FZY_ERROR( "queue_pop :: underflow, empty" );
-    return NULL;
+    *count = 0;
+    return 0;
   }
 
-  void *res = &queue->data[ queue->front * queue->type_size ];
-  queue->front = ( queue->front + 1 ) % queue->capacity;
-  queue->count--;
-  return res;
+  u32 run = queue->capacity - queue->front;
+  *count = run < queue->count ? run : queue->count;
+  return &queue->data[ (u64)queue->front * queue->type_size ];
+} // ---------------------------------------------------------------------------
+
+void queue_consume( queue* queue, u32 count )
+{
+  if( count > queue->count ) count = queue->count;
+
+  queue->front = queue_slot( queue, count );
+  queue->count -= count;
+  if( !queue->count ) queue->front = 0;   // keeps the next batch in one span
 } // ---------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+#include "core/fzy_spsc_queue.h"
+
+#include "core/fzy_atomic.h"
+#include "core/fzy_logger.h"
+#include "core/fzy_mem.h"
+
+/*
+  @brief Represents a spsc queue.  head and tail only ever increase, the slot is the index masked
+    by the capacity.  Each side keeps a cached copy of the other side's index so it only reads the
+    shared line when the cached value says the queue is full or empty
+*/
+typedef struct spsc_queue
+{
+  // written by the consumer
+  volatile u64 head;
+  u64 cached_tail;
+  u8 consumer_pad[ MEMORY_ALIGNMENT_CACHE_LINE - 2 * sizeof( u64 ) ];
+
+  // written by the producer
+  volatile u64 tail;
+  u64 cached_head;
+  u8 producer_pad[ MEMORY_ALIGNMENT_CACHE_LINE - 2 * sizeof( u64 ) ];
+
+  // read only after creation
+  u8* data;
+  u64 mask;
+  u32 capacity;
+  u32 type_size;
+  u8 memory_tag;
+
+} spsc_queue;
+// ---------------------------------------------------------------------------
+
+// copies count elements starting at index into the ring, in at most two copies
+static void spsc_copy_in( spsc_queue* queue, u64 index, const void* data, u32 count )
+{
+  u32 slot = (u32)( index & queue->mask );
+  u32 first = queue->capacity - slot;
+  if( first > count ) first = count;
+
+  memory_copy( queue->data + (u64)slot * queue->type_size, data, (u64)first * queue->type_size );
+  if( count > first )
+    memory_copy( queue->data, (const u8*)data + (u64)first * queue->type_size, (u64)( count - first ) * queue->type_size );
+} // ---------------------------------------------------------------------------
+
+// copies count elements starting at index out of the ring, in at most two copies
+static void spsc_copy_out( spsc_queue* queue, u64 index, void* out, u32 count )
+{
+  u32 slot = (u32)( index & queue->mask );
+  u32 first = queue->capacity - slot;
+  if( first > count ) first = count;
+
+  memory_copy( out, queue->data + (u64)slot * queue->type_size, (u64)first * queue->type_size );
+  if( count > first )
+    memory_copy( (u8*)out + (u64)first * queue->type_size, queue->data, (u64)( count - first ) * queue->type_size );
+} // ---------------------------------------------------------------------------
+
+spsc_queue* _spsc_queue_create( u32 type_size, u32 capacity, u8 memory_tag )
+{
+  u32 rounded = 1;
+  while( rounded < capacity && rounded < 0x80000000u ) rounded <<= 1;
+
+  spsc_queue* queue = memory_allocate_aligned( sizeof( struct spsc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+  if( !queue ) return 0;
+
+  queue->data = memory_allocate_aligned_uninitialized( (u64)type_size * rounded, MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+  if( !queue->data )
+  {
+    memory_delete_aligned( queue, sizeof( struct spsc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, memory_tag );
+    return 0;
+  }
+
+  queue->head = 0;
+  queue->cached_tail = 0;
+  queue->tail = 0;
+  queue->cached_head = 0;
+  queue->mask = rounded - 1;
+  queue->capacity = rounded;
+  queue->type_size = type_size;
+  queue->memory_tag = memory_tag;
+  return queue;
+} // ---------------------------------------------------------------------------
+
+void spsc_queue_destroy( spsc_queue* queue )
+{
+  if( !queue ) return;
+
+  u8 tag = queue->memory_tag;
+  memory_delete_aligned( queue->data, (u64)queue->type_size * queue->capacity, MEMORY_ALIGNMENT_CACHE_LINE, tag );
+  memory_delete_aligned( queue, sizeof( struct spsc_queue ), MEMORY_ALIGNMENT_CACHE_LINE, tag );
+} // ---------------------------------------------------------------------------
+
+b8 spsc_queue_push( spsc_queue* queue, const void* data )
+{
+  return spsc_queue_push_n( queue, data, 1 ) == 1;
+} // ---------------------------------------------------------------------------
+
+u32 spsc_queue_push_n( spsc_queue* queue, const void* data, u32 count )
+{
+  u64 tail = queue->tail;   // only this thread writes tail
+  u64 free_slots = queue->capacity - ( tail - queue->cached_head );
+  if( free_slots < count )
+  {
+    queue->cached_head = atomic_u64_load( &queue->head );
+    free_slots = queue->capacity - ( tail - queue->cached_head );
+  }
+
+  if( count > free_slots ) count = (u32)free_slots;
+  if( !count ) return 0;
+
+  spsc_copy_in( queue, tail, data, count );
+  atomic_u64_store( &queue->tail, tail + count );   // publishes the copied elements
+  return count;
+} // ---------------------------------------------------------------------------
+
+b8 spsc_queue_pop( spsc_queue* queue, void* out )
+{
+  return spsc_queue_pop_n( queue, out, 1 ) == 1;
+} // ---------------------------------------------------------------------------
+
+u32 spsc_queue_pop_n( spsc_queue* queue, void* out, u32 count )
+{
+  u64 head = queue->head;   // only this thread writes head
+  u64 available = queue->cached_tail - head;
+  if( available < count )
+  {
+    queue->cached_tail = atomic_u64_load( &queue->tail );
+    available = queue->cached_tail - head;
+  }
+
+  if( count > available ) count = (u32)available;
+  if( !count ) return 0;
+
+  spsc_copy_out( queue, head, out, count );
+  atomic_u64_store( &queue->head, head + count );   // hands the slots back to the producer
+  return count;
+} // ---------------------------------------------------------------------------
+
+u32 spsc_queue_size( spsc_queue* queue )
+{
+  u64 head = atomic_u64_load( &queue->head );
+  u64 tail = atomic_u64_load( &queue->tail );
+  return tail > head ? (u32)( tail - head ) : 0;
+} // ---------------------------------------------------------------------------
+
+u32 spsc_queue_capacity( spsc_queue* queue )
+{
+  return queue->capacity;
+} // ---------------------------------------------------------------------------
@@ -70,13 +70,9 @@ i32 string_format_v( char* dest, const char* format, va_list  args )
 {
     if (dest)
     {
-        // Big, but can fit on the stack.
-        char buffer[32000];
-        i32 written = vsnprintf(buffer, 32000, format, args );
-        buffer[written] = 0;
-        memory_copy( dest, buffer, written + 1 );
-
-        return written;
+        // formats straight into dest, with the same bound the append functions use
+        i32 written = vsnprintf( dest, max_buffer, format, args );
+        return written < (i32)max_buffer ? written : (i32)max_buffer - 1;
     }
     return -1;
 } // ---------------------------------------------------------------------------------------------------------------
@@ -419,3 +415,193 @@ void string_filename_no_extension_from_path( char* dest, const char* path )
 
     string_substring(dest, path, (i32)start, (i32)(end - start));
 } // ---------------------------------------------------------------------------------------------------------------
+
+string_view string_view_from( const char* str )
+{
+    string_view view = { str, str ? string_length( str ) : 0 };
+    return view;
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_view string_view_create( const char* data, u64 length )
+{
+    string_view view = { data, length };
+    return view;
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_view_is_equal( string_view a, string_view b )
+{
+    return a.length == b.length && ( a.length == 0 || memcmp( a.data, b.data, a.length ) == 0 );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_view_is_equal_cstr( string_view view, const char* str )
+{
+    // stops at the first difference, str is never read past its terminator
+    u64 i = 0;
+    for( ; i < view.length; ++i )
+    {
+        if( str[i] != view.data[i] ) return false;
+    }
+    return str[i] == 0;
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_view string_view_substring( string_view view, u64 start, u64 length )
+{
+    if( start > view.length ) start = view.length;
+    if( length > view.length - start ) length = view.length - start;
+    return string_view_create( view.data + start, length );
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_view string_view_trim( string_view view )
+{
+    while( view.length && isspace( (unsigned char)view.data[0] ) )
+    {
+        view.data++;
+        view.length--;
+    }
+    while( view.length && isspace( (unsigned char)view.data[view.length - 1] ) ) view.length--;
+    return view;
+} // ---------------------------------------------------------------------------------------------------------------
+
+i64 string_view_index_of( string_view view, char c )
+{
+    if( !view.length ) return -1;
+
+    const char* found = memchr( view.data, c, view.length );
+    return found ? (i64)( found - view.data ) : -1;
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_view_split( string_view* remaining, char delimiter, string_view* out_token )
+{
+    if( !remaining->length ) return false;
+
+    i64 index = string_view_index_of( *remaining, delimiter );
+    if( index < 0 )
+    {
+        *out_token = *remaining;
+        remaining->data += remaining->length;
+        remaining->length = 0;
+        return true;
+    }
+
+    *out_token = string_view_create( remaining->data, (u64)index );
+    remaining->data += index + 1;
+    remaining->length -= index + 1;
+    return true;
+} // ---------------------------------------------------------------------------------------------------------------
+
+// copies a view into a small buffer so the sscanf based parsers can read it
+static b8 string_view_terminate( string_view view, char* buffer, u64 size )
+{
+    if( !view.data || view.length >= size ) return false;
+    memory_copy( buffer, view.data, view.length );
+    buffer[view.length] = 0;
+    return true;
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_view_to_f32( string_view view, f32* f )
+{
+    char buffer[64];
+    if( !string_view_terminate( view, buffer, sizeof( buffer ) ) ) return false;
+    return string_to_f32( buffer, f );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_view_to_i32( string_view view, i32* i )
+{
+    char buffer[64];
+    if( !string_view_terminate( view, buffer, sizeof( buffer ) ) ) return false;
+    return string_to_i32( buffer, i );
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_builder string_builder_create( char* buffer, u64 capacity )
+{
+    string_builder builder = { buffer, buffer ? capacity : 0, 0, false };
+    if( builder.capacity ) buffer[0] = 0;
+    return builder;
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_builder string_builder_create_stack( memory_stack* stack, u64 capacity )
+{
+    return string_builder_create( memory_stack_allocate( stack, capacity ), capacity );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append_view( string_builder* builder, string_view view )
+{
+    if( !builder->capacity )
+    {
+        builder->truncated = builder->truncated || view.length;
+        return !view.length;
+    }
+
+    u64 space = builder->capacity - 1 - builder->length;
+    u64 count = view.length < space ? view.length : space;
+    if( count ) memory_copy( builder->data + builder->length, view.data, count );
+    builder->length += count;
+    builder->data[builder->length] = 0;
+
+    if( count < view.length ) builder->truncated = true;
+    return count == view.length;
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append( string_builder* builder, const char* str )
+{
+    return string_builder_append_view( builder, string_view_from( str ) );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append_char( string_builder* builder, char c )
+{
+    return string_builder_append_view( builder, string_view_create( &c, 1 ) );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append_int( string_builder* builder, i64 i )
+{
+    return string_builder_append_format( builder, "%lli", (long long)i );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append_float( string_builder* builder, f32 f )
+{
+    return string_builder_append_format( builder, "%f", f );
+} // ---------------------------------------------------------------------------------------------------------------
+
+b8 string_builder_append_format( string_builder* builder, const char* format, ... )
+{
+    if( !builder->capacity )
+    {
+        builder->truncated = true;
+        return false;
+    }
+
+    u64 space = builder->capacity - builder->length;   // includes the terminator
+    va_list args;
+    va_start( args, format );
+    i32 written = vsnprintf( builder->data + builder->length, space, format, args );
+    va_end( args );
+
+    if( written < 0 )
+    {
+        builder->data[builder->length] = 0;
+        return false;
+    }
+
+    // vsnprintf always terminates, on overflow keep what fit
+    if( (u64)written >= space )
+    {
+        builder->length = builder->capacity - 1;
+        builder->truncated = true;
+        return false;
+    }
+
+    builder->length += written;
+    return true;
+} // ---------------------------------------------------------------------------------------------------------------
+
+string_view string_builder_view( string_builder* builder )
+{
+    return string_view_create( builder->data, builder->length );
+} // ---------------------------------------------------------------------------------------------------------------
+
+void string_builder_reset( string_builder* builder )
+{
+    builder->length = 0;
+    builder->truncated = false;
+    if( builder->capacity ) builder->data[0] = 0;
+} // ---------------------------------------------------------------------------------------------------------------
@@ -3,49 +3,152 @@
 #include "core/fzy_mem.h"
 #include "core/fzy_logger.h"
 
-/* @brief Represents a vector in the engine. Holds what memory type it belongs to */
-typedef struct vector_t
-{
-  u64 size;        // The size of each element in the array
-  u32 capacity;    // The capacity of the array
-  u32 count;       // The number of elements in the array
-  u16 memory_tag;  // The memeory group the vector belongs to
-  void *data;      // The data array
-
-} vector;
-
 // returns a pointer to the address in vector memory
 static inline void *vector_offset( vector *vector, u64 idx )
 {
   return (void*)((u8*)vector->data + (idx * vector->size ) );
 } // ---------------------------------------------------------------------------
 
-vector* vector_create(u64 element_size, u32 capacity, u16 memory_tag)
+// returns true if the data array is the one allocated with the header
+static inline b8 vector_is_inline( vector *vector )
+{
+  return vector->data == (void*)( vector + 1 );
+} // ---------------------------------------------------------------------------
+
+// returns the arena holding the data of a reserved vector
+static inline virtual_arena *vector_arena( vector *vector )
+{
+  return (virtual_arena*)( vector + 1 );
+} // ---------------------------------------------------------------------------
+
+// grows the data array to hold at least capacity elements
+static b8 vector_grow( vector *vector, u32 capacity )
+{
+  if( capacity <= vector->capacity ) return true;
+
+  if( vector->reserved )
+  {
+    // grow in place, the elements never move
+    virtual_arena *arena = vector_arena( vector );
+    if( !virtual_arena_commit( arena, vector->size * capacity ) )
+    {
+      FZY_WARNING( "vector_grow :: reserved vector can't hold %u elements.", capacity );
+      return false;
+    }
+    u64 committed = arena->committed / vector->size;
+    vector->capacity = committed > arena->reserved / vector->size ? (u32)( arena->reserved / vector->size ) : (u32)committed;
+    return true;
+  }
+
+  void *new_data = 0;
+  if( vector_is_inline( vector ) )
+  {
+    // the header block can't grow, move the elements into their own block
+    new_data = vector->allocator.allocate( vector->allocator.context, vector->size * capacity, vector->file, vector->line );
+    if( new_data )
+      memory_copy( new_data, vector->data, vector->size * vector->count );
+  }
+  else
+  {
+    new_data = vector->allocator.reallocate( vector->allocator.context, vector->data, vector->size * vector->capacity, vector->size * capacity,
+                                             vector->file, vector->line );
+  }
+
+  if( !new_data )
+  {
+    FZY_WARNING( "vector_grow :: failed to reallocate data array." );
+    return false;
+  }
+  vector->data = new_data;
+  vector->capacity = capacity;
+  return true;
+} // ---------------------------------------------------------------------------
+
+// grows the data array geometrically so it can hold at least count elements
+static b8 vector_grow_to_fit( vector *vector, u32 count )
+{
+  if( count <= vector->capacity ) return true;
+
+  u32 capacity = vector->capacity ? vector->capacity * 2 : 4;
+  if( capacity < count ) capacity = count;
+  return vector_grow( vector, capacity );
+} // ---------------------------------------------------------------------------
+
+vector* _vector_create(u64 element_size, u32 capacity, u16 memory_tag, const char *file, u32 line)
+{
+  memory_allocator allocator = memory_allocator_heap( memory_tag );
+  vector* v = _vector_create_with_allocator( element_size, capacity, &allocator, file, line );
+  if( v ) v->memory_tag = memory_tag;
+  return v;
+} // ---------------------------------------------------------------------------
+
+vector* _vector_create_with_allocator( u64 element_size, u32 capacity, const memory_allocator* allocator,
+                                       const char *file, u32 line )
 {
-  vector* v = memory_allocate(sizeof(vector), memory_tag);
+  // small vectors get a few elements for free instead of growing straight away
+  if( element_size && element_size * capacity < FZY_VECTOR_INLINE_BYTES )
+    capacity = (u32)( FZY_VECTOR_INLINE_BYTES / element_size );
+
+  // the header and the initial data array share a single allocation, elements
+  // past count are never read so the block is not zeroed
+  vector* v = allocator->allocate( allocator->context, sizeof( struct vector_t ) + element_size * capacity, file, line );
   if (!v) return 0;
 
   v->size = element_size;
   v->count = 0;
   v->capacity = capacity;
-  v->memory_tag = memory_tag;
-  v->data = memory_allocate(v->size * v->capacity, memory_tag);
-  if (!v->data) {
-      memory_delete(v, sizeof(vector), memory_tag);
-      return 0;
+  v->inline_capacity = capacity;
+  v->memory_tag = MEM_TAG_UNKNOWN;
+  v->reserved = false;
+  v->allocator = *allocator;
+  v->data = v + 1;
+  v->file = file;
+  v->line = line;
+  return v;
+} // ---------------------------------------------------------------------------
+
+vector* _vector_create_reserved( u64 element_size, u32 max_capacity, u16 memory_tag, const char *file, u32 line )
+{
+  vector* v = _memory_allocate_uninitialized( sizeof( struct vector_t ) + sizeof( struct virtual_arena ), memory_tag, file, line );
+  if( !v ) return 0;
+
+  virtual_arena* arena = vector_arena( v );
+  if( !virtual_arena_create( arena, element_size * max_capacity, memory_tag ) )
+  {
+    memory_delete( v, sizeof( struct vector_t ) + sizeof( struct virtual_arena ), memory_tag );
+    return 0;
   }
+
+  v->size = element_size;
+  v->count = 0;
+  v->capacity = 0;
+  v->inline_capacity = 0;
+  v->memory_tag = memory_tag;
+  v->reserved = true;
+  v->allocator = memory_allocator_heap( memory_tag );
+  v->data = arena->base;
+  v->file = file;
+  v->line = line;
   return v;
 } // ---------------------------------------------------------------------------
 
 void vector_destroy( vector *vector )
 {
   if( !vector ) return;
-  if( vector->data )
+  if( vector->reserved )
   {
-    memory_delete(vector->data, vector->size * vector->capacity, vector->memory_tag);
+    virtual_arena_destroy( vector_arena( vector ) );
     vector->data = 0;
+    memory_delete( vector, sizeof( struct vector_t ) + sizeof( struct virtual_arena ), vector->memory_tag );
+    return;
+  }
+  memory_allocator allocator = vector->allocator;
+  if( vector->data && !vector_is_inline( vector ) )
+  {
+    allocator.free( allocator.context, vector->data, vector->size * vector->capacity );
   }
-  memory_delete(vector, sizeof(vector), vector->memory_tag);
+  vector->data = 0;
+  allocator.free( allocator.context, vector, sizeof( struct vector_t ) + vector->size * vector->inline_capacity );
 
 } // ---------------------------------------------------------------------------
 
@@ -59,14 +162,10 @@ void vector_push( vector *vector, void *element )
   // grow the vector
   if( vector->count == vector->capacity )
   {
-    u64 new_size = vector->size * vector->capacity * 2;
-    void *new_data = memory_reallocate( vector->data, vector->size * vector->capacity, new_size, vector->memory_tag );
-    if( !new_data )
+    if( !vector_grow_to_fit( vector, vector->count + 1 ) )
     {
       FZY_ERROR( "fzy_vector_push :: failed to reallocate data array." );
     }
-    vector->data = new_data;
-    vector->capacity *= 2;
   }
 
   pos = (u8*)vector->data + (vector->count * vector->size );
@@ -100,28 +199,25 @@ void *_vector_get( vector *vector, u32 index )
   return 0;
 } // ---------------------------------------------------------------------------
 
+// returns the index of the first element equal to element, or count if there is none
+static u32 vector_find( vector *vector, void *element )
+{
+  u8* pos = (u8*)vector->data;
+  for( u32 i = 0; i < vector->count; ++i )
+  {
+    if( memory_compare( pos, element, vector->size ) == 0 ) return i;
+    pos += vector->size;
+  }
+  return vector->count;
+} // ---------------------------------------------------------------------------
+
 void vector_remove( vector *vector, void *element )
 {
   #ifdef FZY_CONFIG_DEBUG
     if( vector == 0 ) FZY_ERROR( "fzy_vector_remove :: vector is null." );
   #endif
 
-  u8* pos = (u8*)vector->data;
-  for (u32 i = 0; i < vector->count; ++i)
-  {
-    if (memory_compare(pos, element, vector->size) == 0)
-    {
-      u32 count = vector->capacity - i - 1;
-      u64 remainder = count * vector->size;
-      if (!memory_copy(pos, pos + vector->size, remainder))
-      {
-        FZY_ERROR("fzy_vector_remove :: failed to copy memory.");
-      }
-      vector->count--;
-      return;
-    }
-    pos += vector->size;
-  }
+  vector_remove_index( vector, vector_find( vector, element ) );
 } // ---------------------------------------------------------------------------
 
 void vector_remove_index( vector *vector, u32 index )
@@ -132,18 +228,112 @@ void vector_remove_index( vector *vector, u32 index )
 
   if( index < vector->count )
   {
+    // close the gap, only the elements after the index are moved
     u8 *pos = (u8*)vector_offset( vector, index );
-    u32 count = vector->capacity - index - 1;
-    u64 remainder = count * vector->size;
-    pos = memory_copy( pos, pos + vector->size, remainder );
-    if( !pos )
-    {
-      FZY_ERROR( "fzy_vector_remove_index :: failed to copy memory" );
-    }
+    memory_move( pos, pos + vector->size, ( vector->count - index - 1 ) * vector->size );
     vector->count--;
   }
 } // ---------------------------------------------------------------------------
 
+void vector_remove_swap( vector *vector, void *element )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_remove_swap :: vector is null." );
+  #endif
+
+  vector_remove_index_swap( vector, vector_find( vector, element ) );
+} // ---------------------------------------------------------------------------
+
+void vector_remove_index_swap( vector *vector, u32 index )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_remove_index_swap :: vector is null." );
+  #endif
+
+  if( index < vector->count )
+  {
+    vector->count--;
+    if( index != vector->count )
+      memory_copy( vector_offset( vector, index ), vector_offset( vector, vector->count ), vector->size );
+  }
+} // ---------------------------------------------------------------------------
+
+u32 vector_remove_if( vector *vector, b8 (*predicate)( void* element, void* user_data ), void* user_data )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_remove_if :: vector is null." );
+  #endif
+
+  // compact the kept elements towards the front
+  u32 kept = 0;
+  for( u32 i = 0; i < vector->count; i++ )
+  {
+    void* element = vector_offset( vector, i );
+    if( predicate( element, user_data ) ) continue;
+    if( kept != i ) memory_copy( vector_offset( vector, kept ), element, vector->size );
+    kept++;
+  }
+
+  u32 removed = vector->count - kept;
+  vector->count = kept;
+  return removed;
+} // ---------------------------------------------------------------------------
+
+b8 vector_reserve( vector *vector, u32 capacity )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_reserve :: vector is null." );
+  #endif
+
+  return vector_grow( vector, capacity );
+} // ---------------------------------------------------------------------------
+
+b8 vector_resize( vector *vector, u32 count )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_resize :: vector is null." );
+  #endif
+
+  if( count > vector->count )
+  {
+    if( !vector_grow_to_fit( vector, count ) ) return false;
+    memory_zero( vector_offset( vector, vector->count ), ( count - vector->count ) * vector->size );
+  }
+  vector->count = count;
+  return true;
+} // ---------------------------------------------------------------------------
+
+b8 vector_insert_range( vector *vector, u32 index, const void *data, u32 count )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_insert_range :: vector is null." );
+    if( index > vector->count ) FZY_ERROR( "fzy_vector_insert_range :: index %u is past the end.", index );
+  #endif
+
+  if( !count ) return true;
+  if( !vector_grow_to_fit( vector, vector->count + count ) ) return false;
+
+  u8* pos = (u8*)vector_offset( vector, index );
+  memory_move( pos + count * vector->size, pos, ( vector->count - index ) * vector->size );
+  memory_copy( pos, data, count * vector->size );
+  vector->count += count;
+  return true;
+} // ---------------------------------------------------------------------------
+
+b8 vector_append_range( vector *vector, const void *data, u32 count )
+{
+  #ifdef FZY_CONFIG_DEBUG
+    if( vector == 0 ) FZY_ERROR( "fzy_vector_append_range :: vector is null." );
+  #endif
+
+  if( !count ) return true;
+  if( !vector_grow_to_fit( vector, vector->count + count ) ) return false;
+
+  memory_copy( vector_offset( vector, vector->count ), data, count * vector->size );
+  vector->count += count;
+  return true;
+} // ---------------------------------------------------------------------------
+
 u32 vector_size( vector *vector )
 {
   #ifdef FZY_CONFIG_DEBUG
@@ -173,15 +363,29 @@ void vector_shrink( vector *vector )
   #ifdef FZY_CONFIG_DEBUG
     if( vector == 0 ) FZY_ERROR( "fzy_vector_shrink :: vector is null." );
   #endif
-  if( vector->count == vector->capacity )
+  if( vector->count == vector->capacity || vector_is_inline( vector ) || vector->reserved )
+  {
+    return;
+  }
+
+  // the elements fit back in the header block, release the data array
+  if( vector->count <= vector->inline_capacity )
   {
+    void* old_data = vector->data;
+    u64 old_size = vector->size * vector->capacity;
+    vector->data = vector + 1;
+    memory_copy( vector->data, old_data, vector->size * vector->count );
+    vector->allocator.free( vector->allocator.context, old_data, old_size );
+    vector->capacity = vector->inline_capacity;
     return;
   }
 
-  void* new_data = memory_reallocate( vector->data,
-                                      vector->size * vector->capacity,
-                                      vector->size * vector->count,
-                                      vector->memory_tag );
+  void* new_data = vector->allocator.reallocate( vector->allocator.context,
+                                                 vector->data,
+                                                 vector->size * vector->capacity,
+                                                 vector->size * vector->count,
+                                                 vector->file,
+                                                 vector->line );
 
   if( new_data )
   {
@@ -198,36 +402,12 @@ void vector_fill( vector *vector, void *data, u32 count, b8 trunc )
 
   if( trunc )
   {
-    if( vector->capacity < count )
-    {
-      u64 new_size = vector->size * count;
-      vector->capacity = count;
-      void* new_data = memory_reallocate( vector->data, vector->size * vector->capacity, new_size, vector->memory_tag );
-      if( !new_data )
-      {
-        FZY_ERROR( "fzy_vector_fill :: failed to reallocate data array." );
-      }
-      memory_copy( vector->data, new_data, vector->size * count );
-      vector->count = count;
-    }
+    vector->count = 0;
   }
-  else
-  {
-    if( vector->capacity < vector->count + count )
-    {
-      u64 new_size = vector->size * vector->capacity * 2;
-      void *new_data = memory_reallocate( vector->data, vector->size * vector->capacity, new_size, vector->memory_tag );
-      if( !new_data )
-      {
-        FZY_ERROR( "fzy_vector_push :: failed to reallocate data array." );
-      }
-      vector->data = new_data;
-      vector->capacity *= 2;
-    }
 
-    u8* pos = (u8*)vector->data + (vector->count * vector->size );
-    pos = memory_copy( pos, data, vector->size * count );
-    vector->count += count;
+  if( !vector_append_range( vector, data, count ) )
+  {
+    FZY_ERROR( "fzy_vector_fill :: failed to reallocate data array." );
   }
 
 } // ---------------------------------------------------------------------------
@@ -18,6 +18,7 @@ static u32 living_count = 0;    // tracks number of living entities
 static component_array *components[ MAX_COMPONENTS ];
 static queue *component_types = 0;
 static hashtable *component_registeration = 0;
+static memory_pool *component_type_pool = 0;  // storage for the registered type ids
 
 //----------------------------------------------------------------------------
 //  process management
@@ -25,6 +26,7 @@ static hashtable *component_registeration = 0;
 static process *processes[ MAX_PROCESSES ];    // track the processes being used
 static queue* process_types = NULL;
 static hashtable *process_registeration = 0;
+static memory_pool *process_type_pool = 0;    // storage for the registered type ids
 
 //----------------------------------------------------------------------------
 //  component helper functions
@@ -37,20 +39,30 @@ static inline void *array_offset( component_array *array, u32 idx )
 
 static void unregister_component_type( void* t )
 {
-  memory_delete( t, sizeof( u8 ), MEM_TAG_COMPONENT );
+  memory_pool_free( component_type_pool, t );
 } // ----------------------------------------------------------------------
 
 static void unregister_process_type( void* t )
 {
-  memory_delete( t, sizeof( u8 ), MEM_TAG_PROCESS );
+  memory_pool_free( process_type_pool, t );
 } // ----------------------------------------------------------------------
 
 static component_array *component_array_create( u32 type_size )
 {
-  component_array *array = memory_allocate( sizeof( struct component_array ), MEM_TAG_COMPONENT );
+  // every field is written below, skip zeroing the index maps
+  component_array *array = memory_allocate_uninitialized( sizeof( struct component_array ), MEM_TAG_COMPONENT );
+  if( !array ) return 0;
+
   array->type_size = type_size;
   array->idx = 0;
-  array->components = memory_allocate( type_size * MAX_ENTITIES, MEM_TAG_COMPONENT );
+  if( !virtual_arena_create( &array->storage, (u64)type_size * MAX_ENTITIES, MEM_TAG_COMPONENT ) )
+  {
+    // the storage was never reserved, free the array itself rather than destroying it
+    FZY_WARNING( "component_array_create :: failed to reserve component storage" );
+    memory_delete( array, sizeof( struct component_array ), MEM_TAG_COMPONENT );
+    return 0;
+  }
+  array->components = array->storage.base;
 
   memory_set( array->entity_to_index, -1, MAX_ENTITIES * sizeof( i32 ));
   memory_set( array->index_to_entity, -1, MAX_ENTITIES * sizeof( i32 ));
@@ -61,7 +73,7 @@ static void component_array_destroy( component_array *array )
 {
   if( array )
   {
-    memory_delete( array->components, array->type_size * MAX_ENTITIES, MEM_TAG_COMPONENT );
+    virtual_arena_destroy( &array->storage );
     memory_delete( array, sizeof( struct component_array ), MEM_TAG_COMPONENT );
     array = 0;
   }
@@ -77,8 +89,13 @@ static void* component_array_add( component_array *array, entity entity )
       FZY_WARNING( "component_array_insert :: assigning component to entity more than once" );
   #endif
 
-  // Put new entry at end
+  // Put new entry at end, committing another page of storage if needed
   i32 newIndex = array->idx;
+  if( !virtual_arena_commit( &array->storage, (u64)( newIndex + 1 ) * array->type_size ) )
+  {
+    FZY_ERROR( "component_array_add :: failed to commit component storage" );
+    return 0;
+  }
   array->entity_to_index[ entity ] = newIndex;
   array->index_to_entity[ newIndex ] = entity;
   void *a_idx = array_offset( array, newIndex );
@@ -122,6 +139,31 @@ void* component_array_get( component_array *array, entity entity )
   return array_offset( array, array->entity_to_index[ entity ] );
 } // ----------------------------------------------------------------
 
+// adds the entity to the process once
+static void process_add_entity( process* process, entity entity )
+{
+  if( process->entity_to_index[ entity ] != -1 ) return;
+
+  process->entity_to_index[ entity ] = vector_size( process->entities );
+  vector_entity_push( process->entities, entity );
+} // ------------------------------------------------------------------
+
+// removes the entity in O(1) by moving the last entity into its slot
+static void process_remove_entity( process* process, entity e )
+{
+  i32 index = process->entity_to_index[ e ];
+  if( index == -1 ) return;
+
+  u32 last = vector_size( process->entities ) - 1;
+  if( (u32)index != last )
+  {
+    entity moved = *vector_entity_get( process->entities, last );
+    process->entity_to_index[ moved ] = index;
+  }
+  vector_remove_index_swap( process->entities, index );
+  process->entity_to_index[ e ] = -1;
+} // ------------------------------------------------------------------
+
 void process_entity_signature_changed( entity entity, signature signature )
 {
   for( u8 i = 0; i < MAX_PROCESSES; i++ )
@@ -130,11 +172,11 @@ void process_entity_signature_changed( entity entity, signature signature )
     {
       if ((signature & processes[i]->signature) == processes[i]->signature)
       {
-        vector_push( processes[ i ]->entities, &entity );
+        process_add_entity( processes[ i ], entity );
       }
       else
       {
-        vector_remove( processes[ i ]->entities, &entity );
+        process_remove_entity( processes[ i ], entity );
       }
     }
   }
@@ -157,22 +199,27 @@ b8 ecs_initialize( void )
   component_registeration = hashtable_create( MAX_COMPONENTS * 2 );
   process_registeration = hashtable_create( MAX_COMPONENTS * 2 );
 
-  for( u16 i = 0; i < MAX_ENTITIES; i++ )
-  {
-    queue_push( entity_queue, &i );
-    entity_signatures[ i ] = 0;
+  // create pools for the registered type ids
+  component_type_pool = memory_pool_create( u8, MAX_COMPONENTS, MEM_TAG_COMPONENT );
+  process_type_pool = memory_pool_create( u8, MAX_PROCESSES, MEM_TAG_PROCESS );
 
-    if( i < MAX_COMPONENTS )
-    {
-      queue_push( component_types, &i );
-      components[ i ] = NULL;
-    }
-    if( i < MAX_PROCESSES )
-    {
-      queue_push( process_types, &i );
-      processes[ i ] = NULL;
-    }
+  // fill the free lists a batch at a time
+  entity ids[ 256 ];
+  for( u32 base = 0; base < MAX_ENTITIES; base += 256 )
+  {
+    u32 count = MAX_ENTITIES - base < 256 ? MAX_ENTITIES - base : 256;
+    for( u32 i = 0; i < count; i++ ) ids[ i ] = (entity)( base + i );
+    queue_push_n( entity_queue, ids, count );
   }
+
+  u8 types[ MAX_COMPONENTS > MAX_PROCESSES ? MAX_COMPONENTS : MAX_PROCESSES ];
+  for( u32 i = 0; i < sizeof( types ); i++ ) types[ i ] = (u8)i;
+  queue_push_n( component_types, types, MAX_COMPONENTS );
+  queue_push_n( process_types, types, MAX_PROCESSES );
+
+  memory_zero( entity_signatures, sizeof( entity_signatures ) );
+  for( u32 i = 0; i < MAX_COMPONENTS; i++ ) components[ i ] = NULL;
+  for( u32 i = 0; i < MAX_PROCESSES; i++ ) processes[ i ] = NULL;
   return true;
 } // --------------------------------------------------------------------------
 
@@ -211,6 +258,11 @@ b8 ecs_shutdown( void )
     process_registeration = 0;
   }
 
+  memory_pool_destroy( component_type_pool );
+  component_type_pool = 0;
+  memory_pool_destroy( process_type_pool );
+  process_type_pool = 0;
+
   for( u8 i = 0; i < MAX_PROCESSES; i++ )
     if( processes[ i ] )
       process_destroy( processes[ i ] );
@@ -225,7 +277,8 @@ entity entity_create( void )
 {
   if( living_count < MAX_ENTITIES )
   {
-    entity e = *((entity*)queue_pop( entity_queue ) );
+    entity e;
+    queue_pop( entity_queue, &e );
     living_count++;
     return e;
   }
@@ -257,7 +310,7 @@ void entity_destroy( entity entity )
   for( u8 i = 0; i < MAX_PROCESSES; i++ )
   {
     if( processes[ i ] )
-      vector_remove( processes[ i ]->entities, &entity );
+      process_remove_entity( processes[ i ], entity );
   }
 } // --------------------------------------------------------------------------
 
@@ -271,11 +324,15 @@ component_type_id component_register( const char* name, u32 type_size )
   if( rt )
     FZY_ERROR( "component_register :: type is already registered" );
 
-  rt = memory_allocate( sizeof( u8 ), MEM_TAG_COMPONENT );
-  *rt = *((u8*)queue_pop( component_types ));
+  rt = memory_pool_allocate( component_type_pool, false );
+  queue_pop( component_types, rt );
   hashtable_set( component_registeration, name, rt );
 
+  // the type stays registered with no array, component_add and component_get already skip it
   components[ *rt ] = component_array_create( type_size );
+  if( !components[ *rt ] )
+    FZY_WARNING( "component_register :: failed to create the component array for %s", name );
+
   return *rt;
 } // --------------------------------------------------------------------------
 
@@ -290,7 +347,9 @@ void component_unregister( const char *name, component_type_id type_id )
     if( components[ *rt ] )
     {
       component_array_destroy( components[ *rt ] );
+      components[ *rt ] = 0;
     }
+    memory_pool_free( component_type_pool, rt );
   }
 } // --------------------------------------------------------------------------
 
@@ -329,9 +388,10 @@ void* component_get( entity entity, component_type_id type_id )
 process* process_create( signature signature )
 {
   process *s = memory_allocate( sizeof( struct process ), MEM_TAG_PROCESS );
-  s->entities = vector_create( sizeof( entity ), 64, MEM_TAG_PROCESS );
+  s->entities = vector_entity_create( 64, MEM_TAG_PROCESS );
   s->signature = signature;
   s->update_fn = 0;
+  memory_set( s->entity_to_index, -1, sizeof( s->entity_to_index ) );
   return s;
 } // --------------------------------------------------------------------------
 
@@ -355,8 +415,8 @@ process_type_id process_register( const char* name, process* process )
  if( rt != 0 )
    FZY_ERROR( "process_register :: process is already registered" );
 
-  rt = memory_allocate( sizeof( u8 ), MEM_TAG_PROCESS );
-  *rt = *((u8*)queue_pop( process_types ));
+  rt = memory_pool_allocate( process_type_pool, false );
+  queue_pop( process_types, rt );
   hashtable_set( process_registeration, name, rt );
 
   processes[ *rt ] = process;
@@ -368,13 +428,13 @@ void process_unregister( const char* name, process_type_id type_id )
   u8* rt = hashtable_remove( process_registeration, name );
   if( rt )
   {
-    hashtable_remove( process_registeration, name );
     queue_push( process_types, rt );
     if( processes[ *rt ] )
     {
       process_destroy( processes[ *rt ] );
       processes[ *rt ] = 0;
     }
+    memory_pool_free( process_type_pool, rt );
   }
 } // --------------------------------------------------------------------------
 
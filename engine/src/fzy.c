@@ -2,7 +2,9 @@
 #include "core/fzy_logger.h"
 #include "core/fzy_clock.h"
 #include "core/fzy_mem.h"
+#include "core/fzy_string.h"
 #include "core/fzy_event.h"
+#include "core/fzy_name.h"
 #include "core/fzy_input.h"
 #include "renderer/fzy_window.h"
 
@@ -49,6 +51,12 @@ static b8 initialize_core( const char* title )
     return false;
   }
 
+  if( !name_system_initialize() )
+  {
+    FZY_ERROR( "fzy_initialize :: failed to initialize the name system" );
+    return false;
+  }
+
   if( !event_system_initialize() )
   {
     FZY_ERROR("fzy_initialize :: failed to initialize the event system" );
@@ -85,7 +93,9 @@ static b8 initialize_core( const char* title )
   is_suspended = false;
 
   #ifdef FZY_CONFIG_DEBUG
-    FZY_INFO( "%s", memory_get_usage_str() );
+    char* usage = memory_get_usage_str();
+    FZY_INFO( "%s", usage );
+    string_free( usage );
   #endif
 
   return true;
@@ -140,8 +150,11 @@ void fzy_shutdown( void )
   if( !ecs_shutdown() ) FZY_ERROR( "fzy_shutdown :: failed to shutdown the ecs" );
   if( !input_system_shutdown() ) FZY_ERROR( "fzy_shutdown :: failed to shutdown the input system" );
   if( !event_system_shutdown() ) FZY_ERROR( "fzy_shutdown :: failed to shutdown the event system" );
+  if( !name_system_shutdown() ) FZY_ERROR( "fzy_shutdown :: failed to shutdown the name system" );
   #ifdef FZY_CONFIG_DEBUG
-    FZY_INFO( "%s", memory_get_usage_str() );
+    char* usage = memory_get_usage_str();
+    FZY_INFO( "%s", usage );
+    string_free( usage );
   #endif
   if( !memory_shutdown( ) ) FZY_ERROR( "fzy_shutdown :: failed to shutdown memory system" );
 
@@ -194,6 +207,9 @@ void fzy_update( void )
     */
     input_system_update( );
 
+    // release all scratch memory handed out during this frame
+    memory_frame_reset( );
+
     // update last time
     last_time = current_time;
   } // is running
@@ -72,4 +72,9 @@ material* material_get( const char* name )
   return (material*)hashtable_get( material_manager, name );
 } // ------------------------------------------------------------------------
 
+material* material_get_id( name_id name )
+{
+  return (material*)hashtable_get_id( material_manager, name );
+} // ------------------------------------------------------------------------
+
 #endif // FZY_RENDERER_OPENGL
@@ -10,6 +10,9 @@
 
 #include <stddef.h>
 
+// index lists are walked per index when meshes are merged
+FZY_VECTOR_DECLARE( u32 )
+
 //----------------------------------------------------------------------------------
 //  resource manager
 // ---------------------------------------------------------------------------------
@@ -110,12 +113,17 @@ static void vertex_buffer_add_vertices( vertex_buffer *vb, vector* verts, vector
   // copy the vertices into the vertex vector
   vector_fill( vb->vertices, _vector_data( verts ), vs, false );
 
-  u32 idx;
+  // offset the indices past the vertices already in the buffer, resize grows geometrically so
+  // merging many meshes doesn't copy the index list every time
+  u32 first = vector_size( vb->indices );
+  if( !vector_resize( vb->indices, first + is ) )
+    FZY_ERROR( "vertex_buffer_add_vertices :: failed to grow the index buffer" );
 
+  u32* source = vector_u32_data( indices );
+  u32* dest = vector_u32_data( vb->indices ) + first;
   for( u32 i = 0; i < is; i++ )
   {
-    idx = vb->vertex_count + *(vector_get( u32, indices, i ) );
-    vector_push( vb->indices, &idx );
+    dest[ i ] = vb->vertex_count + source[ i ];
   }
 
   vb->vertex_count += vs;
@@ -234,6 +242,12 @@ void mesh_manager_shutdown( void )
 {
   if( !mesh_manager ) return;
 
+  #ifdef FZY_CONFIG_DEBUG
+    hashtable_stats stats = hashtable_get_stats( mesh_manager );
+    FZY_INFO( "mesh_manager_shutdown :: %u / %u slots, longest probe %u, average probe %.2f, %llu bytes",
+              stats.count, stats.capacity, stats.longest_probe, stats.average_probe, stats.memory );
+  #endif
+
   hashtable_destroy( mesh_manager, mesh_destroy );
   initialized = false;
   mesh_manager = NULL;
@@ -265,11 +279,22 @@ mesh* mesh_get( const char* name )
   return (mesh*)hashtable_get( mesh_manager, name );
 } // --------------------------------------------------------------------------
 
+mesh* mesh_get_id( name_id name )
+{
+  return (mesh*)hashtable_get_id( mesh_manager, name );
+} // --------------------------------------------------------------------------
+
 void mesh_set_vertices( mesh* mesh, vector* vertices, vector* indices )
 {
   if( !mesh ) return;
-  vector_fill( mesh->buffer->vertices, _vector_data( vertices ), vector_size( vertices ), true );
-  vector_fill( mesh->buffer->indices, _vector_data( indices ), vector_size( indices ), true );
+  mesh_set_vertex_data( mesh, _vector_data( vertices ), vector_size( vertices ), _vector_data( indices ), vector_size( indices ) );
+} // --------------------------------------------------------------------------
+
+void mesh_set_vertex_data( mesh* mesh, const void* vertices, u32 vertex_count, const u32* indices, u32 index_count )
+{
+  if( !mesh ) return;
+  vector_fill( mesh->buffer->vertices, (void*)vertices, vertex_count, true );
+  vector_fill( mesh->buffer->indices, (void*)indices, index_count, true );
   mesh->buffer->dirty = true;
 
   mesh->buffer->vertex_quantity = vector_capacity(mesh->buffer->vertices );
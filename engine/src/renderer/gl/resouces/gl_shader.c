@@ -185,6 +185,11 @@ shader* shader_get( const char* name )
   return (shader*)hashtable_get( shader_manager, name );
 } // -------------------------------------------------------------------------
 
+shader* shader_get_id( name_id name )
+{
+  return (shader*)hashtable_get_id( shader_manager, name );
+} // -------------------------------------------------------------------------
+
 b8 shader_add_uniform( shader* sdr, const char* uniform_name, u8 type )
 {
   if( !sdr ) return false;
@@ -201,14 +206,9 @@ b8 shader_add_uniform( shader* sdr, const char* uniform_name, u8 type )
   return false;
 } // -------------------------------------------------------------------------
 
-void shader_set_uniform( shader* sdr, const char*uniform_name, void* value )
+// uploads the value to the uniform's location based on its type
+static void uniform_upload( gl_uniform* u, void* value )
 {
-  if( !sdr ) return;
-  gl_shader* id = (gl_shader*)sdr->internal_data;
-  gl_uniform *u = (gl_uniform*)hashtable_get( id->uniforms, uniform_name );
-
-  if( !u ) return;
-
   switch( u->type )
   {
     case UNIFORM_TYPE_INT:
@@ -241,6 +241,22 @@ void shader_set_uniform( shader* sdr, const char*uniform_name, void* value )
   }
 } // -------------------------------------------------------------------------
 
+void shader_set_uniform( shader* sdr, const char*uniform_name, void* value )
+{
+  if( !sdr ) return;
+  gl_shader* id = (gl_shader*)sdr->internal_data;
+  gl_uniform *u = (gl_uniform*)hashtable_get( id->uniforms, uniform_name );
+  if( u ) uniform_upload( u, value );
+} // -------------------------------------------------------------------------
+
+void shader_set_uniform_id( shader* sdr, name_id uniform_name, void* value )
+{
+  if( !sdr ) return;
+  gl_shader* id = (gl_shader*)sdr->internal_data;
+  gl_uniform *u = (gl_uniform*)hashtable_get_id( id->uniforms, uniform_name );
+  if( u ) uniform_upload( u, value );
+} // -------------------------------------------------------------------------
+
 void shader_use( shader* sdr )
 {
   if( !sdr ) return;
@@ -77,6 +77,12 @@ void texture_manager_shutdown( void )
 {
   if( !texture_manager ) return;
 
+  #ifdef FZY_CONFIG_DEBUG
+    hashtable_stats stats = hashtable_get_stats( texture_manager );
+    FZY_INFO( "texture_manager_shutdown :: %u / %u slots, longest probe %u, average probe %.2f, %llu bytes",
+              stats.count, stats.capacity, stats.longest_probe, stats.average_probe, stats.memory );
+  #endif
+
   hashtable_destroy( texture_manager, texture_destroy );
   initialized = false;
   texture_manager = NULL;
@@ -206,6 +212,11 @@ void texture_remove( const char* name )
   if( tex ) texture_destroy( tex );
 } // ------------------------------------------------------------------------
 
+texture* texture_get_id( name_id name )
+{
+  return (texture*)hashtable_get_id( texture_manager, name );
+} // ------------------------------------------------------------------------
+
 void texture_bind( texture *texture, u32 active_texture )
 {
   if( !texture )
@@ -2,6 +2,7 @@
 
 #include "core/fzy_mem.h"
 #include "core/fzy_logger.h"
+#include "core/fzy_file.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -11,7 +12,21 @@ image* image_create( const char* path )
   image *img = memory_allocate( sizeof( struct image ), MEM_TAG_TEXTURE );
   img->pixels = NULL;
 
-  img->pixels = stbi_load( path, &img->width, &img->height, &img->channels, 0 );
+  // decode from the scratch stack so the encoded bytes never touch the heap
+  memory_stack* scratch = memory_scratch_stack();
+  memory_stack_marker marker = scratch ? memory_stack_get_marker( scratch ) : 0;
+  file_handle file = { 0 };
+  if( scratch && file_read_stack( path, scratch, &file ) )
+  {
+    img->pixels = stbi_load_from_memory( file.data, (i32)( file.size - 1 ), &img->width, &img->height, &img->channels, 0 );
+    file_close( &file );
+    memory_stack_free_to_marker( scratch, marker );
+  }
+  else
+  {
+    // too large for the scratch stack, let stb stream it
+    img->pixels = stbi_load( path, &img->width, &img->height, &img->channels, 0 );
+  }
 
   if( !img->pixels )
   {
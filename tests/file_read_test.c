@@ -0,0 +1,83 @@
+#include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_file.h"
+#include "core/fzy_string.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+  Reads files with and without a trailing newline and checks that the view, the lines and the
+  bytes read all stop at the end of the file contents, not at the '\0' kept after them.
+*/
+
+static u32 failures = 0;
+
+#define CHECK( cond ) \
+  do { if( !( cond ) ) { printf( "%s:%d  check failed: %s\n", __FILE__, __LINE__, #cond ); failures++; } } while( 0 )
+
+static b8 write_test_file( const char* path, const char* contents )
+{
+  FILE* f = fopen( path, "wb" );
+  if( !f ) return false;
+  fwrite( contents, 1, strlen( contents ), f );
+  fclose( f );
+  return true;
+} // -------------------------------------------------------------------------
+
+static b8 view_equals( string_view view, const char* text )
+{
+  return view.length == strlen( text ) && memcmp( view.data, text, view.length ) == 0;
+} // -------------------------------------------------------------------------
+
+// reads contents back through every file_handle reader, lines holds the line count expected
+static void check_file( const char* contents, const char** lines, u32 line_count )
+{
+  const char* path = "file_read_test.txt";
+  CHECK( write_test_file( path, contents ) );
+
+  file_handle handle;
+  CHECK( file_read( path, &handle ) );
+  if( !handle.data ) return;
+
+  CHECK( view_equals( file_get_view( &handle ), contents ) );
+
+  string_view line;
+  u32 read = 0;
+  while( file_read_line( &handle, &line ) )
+  {
+    CHECK( read < line_count && view_equals( line, lines[ read ] ) );
+    read++;
+  }
+  CHECK( read == line_count );
+
+  // every byte of the contents can be read and nothing past them
+  u64 length = strlen( contents );
+  char bytes[ 64 ];
+  handle.pos = 0;
+  CHECK( file_read_bytes( &handle, length, bytes ) );
+  CHECK( memcmp( bytes, contents, length ) == 0 );
+  CHECK( !file_read_bytes( &handle, 1, bytes ) );
+
+  file_close( &handle );
+  remove( path );
+} // -------------------------------------------------------------------------
+
+int main( int argc, char** argv )
+{
+  (void)argc;
+  (void)argv;
+
+  memory_initialize();
+
+  const char* lines[] = { "first", "second" };
+  check_file( "first\nsecond\n", lines, 2 );
+  check_file( "first\nsecond", lines, 2 );
+  check_file( "first\r\nsecond\r\n", lines, 2 );
+  check_file( "", lines, 0 );
+
+  memory_shutdown();
+
+  printf( "file read, %u failures\n", failures );
+  return failures ? 1 : 0;
+} // -------------------------------------------------------------------------
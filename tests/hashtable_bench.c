@@ -0,0 +1,225 @@
+#include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_hashtable.h"
+
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Times the open addressed hashtable against the chained table it replaced, at 100, 10k and 1M
+  keys.  Every key is inserted, then looked up as a hit and as a miss until ROUNDS_TOTAL lookups
+  of each kind have been made.
+*/
+
+// lookups made of each kind, the small tables repeat their keys so they run long enough to time
+#define ROUNDS_TOTAL 4000000u
+
+// longest key generated, well under MAX_NAME_LENGTH
+#define KEY_LENGTH 24
+
+//----------------------------------------------------------------------------
+//  The chained table the engine used before, kept here as the baseline
+//----------------------------------------------------------------------------
+typedef struct chained_entry
+{
+  char name[ MAX_NAME_LENGTH ];
+  u64 hash;
+  u32 ref_count;
+  void* data;
+  struct chained_entry* next;
+
+} chained_entry;
+
+typedef struct chained_table
+{
+  chained_entry** entries;
+  u32 capacity;
+
+} chained_table;
+
+static inline u64 chained_hash( const char *key )
+{
+  u64 hash = 1469598103934665603ULL;
+  while( *key )
+  {
+    hash ^= (u8)(*key++);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+} // -------------------------------------------------------------------------
+
+static void chained_create( chained_table* table, u32 capacity )
+{
+  table->capacity = capacity;
+  table->entries = calloc( capacity, sizeof( chained_entry* ) );
+} // -------------------------------------------------------------------------
+
+static void chained_destroy( chained_table* table )
+{
+  for( u32 i = 0; i < table->capacity; i++ )
+  {
+    chained_entry* e = table->entries[ i ];
+    while( e )
+    {
+      chained_entry* next = e->next;
+      free( e );
+      e = next;
+    }
+  }
+  free( table->entries );
+} // -------------------------------------------------------------------------
+
+static void chained_set( chained_table* table, const char* key, void* value )
+{
+  u64 hash = chained_hash( key );
+  u32 bucket = hash & ( table->capacity - 1 );
+
+  for( chained_entry* e = table->entries[ bucket ]; e; e = e->next )
+  {
+    if( e->hash == hash && strcmp( e->name, key ) == 0 )
+    {
+      e->ref_count++;
+      return;
+    }
+  }
+
+  chained_entry* e = malloc( sizeof( chained_entry ) );
+  e->hash = hash;
+  strncpy( e->name, key, MAX_NAME_LENGTH - 1 );
+  e->name[ MAX_NAME_LENGTH - 1 ] = 0;
+  e->data = value;
+  e->ref_count = 1;
+  e->next = table->entries[ bucket ];
+  table->entries[ bucket ] = e;
+} // -------------------------------------------------------------------------
+
+static void* chained_get( chained_table* table, const char* key )
+{
+  u64 hash = chained_hash( key );
+  u32 bucket = hash & ( table->capacity - 1 );
+
+  for( chained_entry* e = table->entries[ bucket ]; e; e = e->next )
+  {
+    if( e->hash == hash && strcmp( key, e->name ) == 0 )
+    {
+      e->ref_count++;
+      return e->data;
+    }
+  }
+  return 0;
+} // -------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------
+//  Benchmark
+//----------------------------------------------------------------------------
+static f64 now_seconds( void )
+{
+  return (f64)SDL_GetPerformanceCounter() / (f64)SDL_GetPerformanceFrequency();
+} // -------------------------------------------------------------------------
+
+// fills count keys of KEY_LENGTH bytes each, prefix keeps the hit and miss sets apart
+static char* make_keys( u32 count, const char* prefix )
+{
+  char* keys = malloc( (u64)count * KEY_LENGTH );
+  for( u32 i = 0; i < count; i++ )
+    snprintf( keys + (u64)i * KEY_LENGTH, KEY_LENGTH, "%s_%08x", prefix, i * 2654435761u );
+  return keys;
+} // -------------------------------------------------------------------------
+
+static u32 round_pow2( u32 n )
+{
+  u32 c = 1;
+  while( c < n ) c <<= 1;
+  return c;
+} // -------------------------------------------------------------------------
+
+// nanoseconds per operation
+static f64 per_op( f64 seconds, u64 ops )
+{
+  return seconds * 1e9 / (f64)ops;
+} // -------------------------------------------------------------------------
+
+static void bench( u32 count )
+{
+  char* keys = make_keys( count, "entity" );
+  char* misses = make_keys( count, "absent" );
+  u32 rounds = ROUNDS_TOTAL / count ? ROUNDS_TOTAL / count : 1;
+  u64 lookups = (u64)rounds * count;
+  u64 found = 0;
+
+  // the old table never grew, give it one bucket per key which is its best case
+  chained_table chained;
+  chained_create( &chained, round_pow2( count ) );
+
+  f64 start = now_seconds();
+  for( u32 i = 0; i < count; i++ )
+    chained_set( &chained, keys + (u64)i * KEY_LENGTH, keys + (u64)i * KEY_LENGTH );
+  f64 chained_insert = now_seconds() - start;
+
+  start = now_seconds();
+  for( u32 r = 0; r < rounds; r++ )
+    for( u32 i = 0; i < count; i++ )
+      found += chained_get( &chained, keys + (u64)i * KEY_LENGTH ) != 0;
+  f64 chained_hit = now_seconds() - start;
+
+  start = now_seconds();
+  for( u32 r = 0; r < rounds; r++ )
+    for( u32 i = 0; i < count; i++ )
+      found += chained_get( &chained, misses + (u64)i * KEY_LENGTH ) != 0;
+  f64 chained_miss = now_seconds() - start;
+  chained_destroy( &chained );
+
+  // the hashtable starts small and grows, the way the engine uses it
+  hashtable* table = hashtable_create( 64 );
+
+  start = now_seconds();
+  for( u32 i = 0; i < count; i++ )
+    hashtable_set( table, keys + (u64)i * KEY_LENGTH, keys + (u64)i * KEY_LENGTH );
+  f64 open_insert = now_seconds() - start;
+
+  start = now_seconds();
+  for( u32 r = 0; r < rounds; r++ )
+    for( u32 i = 0; i < count; i++ )
+      found += hashtable_get( table, keys + (u64)i * KEY_LENGTH ) != 0;
+  f64 open_hit = now_seconds() - start;
+
+  start = now_seconds();
+  for( u32 r = 0; r < rounds; r++ )
+    for( u32 i = 0; i < count; i++ )
+      found += hashtable_get( table, misses + (u64)i * KEY_LENGTH ) != 0;
+  f64 open_miss = now_seconds() - start;
+
+  hashtable_stats stats = hashtable_get_stats( table );
+  hashtable_destroy( table, 0 );
+
+  printf( "%8u keys  insert ns/op %7.1f -> %7.1f   hit ns/op %7.1f -> %7.1f   miss ns/op %7.1f -> %7.1f   "
+          "load %.2f, average probe %.2f, longest %u\n",
+          count,
+          per_op( chained_insert, count ), per_op( open_insert, count ),
+          per_op( chained_hit, lookups ), per_op( open_hit, lookups ),
+          per_op( chained_miss, lookups ), per_op( open_miss, lookups ),
+          stats.load_factor, stats.average_probe, stats.longest_probe );
+
+  // every hit was found by both tables and no miss was
+  if( found != lookups * 2 )
+    printf( "  lookup mismatch, %llu of %llu keys found\n", (unsigned long long)found, (unsigned long long)( lookups * 2 ) );
+
+  free( keys );
+  free( misses );
+} // -------------------------------------------------------------------------
+
+int main( int argc, char** argv )
+{
+  (void)argc;
+  (void)argv;
+
+  memory_initialize();
+  printf( "hashtable, chained -> open addressing\n" );
+  bench( 100 );
+  bench( 10000 );
+  bench( 1000000 );
+  memory_shutdown();
+  return 0;
+} // -------------------------------------------------------------------------
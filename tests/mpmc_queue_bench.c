@@ -0,0 +1,136 @@
+#include "defines.h"
+#include "core/fzy_mem.h"
+#include "core/fzy_atomic.h"
+#include "core/fzy_mpmc_queue.h"
+
+#include <SDL3/SDL.h>
+#include <stdio.h>
+
+/*
+  Measures mpmc queue throughput with 1, 2, 4, 8 and 16 producer / consumer pairs.  Every run moves
+  the same number of elements, so the numbers show how the queue holds up as contention grows.
+*/
+
+// elements moved through the queue in each run, split between the producers
+#define ELEMENTS_TOTAL 4000000u
+
+// slots in the queue, small enough that producers and consumers keep meeting
+#define QUEUE_CAPACITY 1024
+
+// failed attempts before a thread gives up the rest of its time slice
+#define SPINS_BEFORE_YIELD 64
+
+typedef struct bench_state
+{
+  mpmc_queue* queue;
+  u64 per_producer;       // elements pushed by each producer
+  u64 total;              // elements pushed by every producer together
+  volatile u64 popped;    // elements popped so far by every consumer
+  volatile u64 sum;       // sum of every popped element, checked against the pushed values
+  volatile u64 ready;     // threads waiting for the start signal
+  volatile u32 start;     // set once every thread is ready
+
+} bench_state;
+
+static f64 now_seconds( void )
+{
+  return (f64)SDL_GetPerformanceCounter() / (f64)SDL_GetPerformanceFrequency();
+} // -------------------------------------------------------------------------
+
+static void wait_for_start( bench_state* state )
+{
+  atomic_u64_add( &state->ready, 1 );
+  while( !atomic_u32_load( &state->start ) ) SDL_Delay( 0 );
+} // -------------------------------------------------------------------------
+
+static void back_off( u32* spins )
+{
+  if( ++*spins < SPINS_BEFORE_YIELD ) return;
+  *spins = 0;
+  SDL_Delay( 0 );
+} // -------------------------------------------------------------------------
+
+static int producer( void* data )
+{
+  bench_state* state = data;
+  wait_for_start( state );
+
+  u32 spins = 0;
+  for( u64 value = 1; value <= state->per_producer; value++ )
+  {
+    while( !mpmc_queue_push( state->queue, &value ) ) back_off( &spins );
+  }
+  return 0;
+} // -------------------------------------------------------------------------
+
+static int consumer( void* data )
+{
+  bench_state* state = data;
+  wait_for_start( state );
+
+  u64 sum = 0;
+  u32 spins = 0;
+  u64 value;
+  while( atomic_u64_load( &state->popped ) < state->total )
+  {
+    if( mpmc_queue_pop( state->queue, &value ) )
+    {
+      sum += value;
+      atomic_u64_add( &state->popped, 1 );
+    }
+    else
+    {
+      back_off( &spins );
+    }
+  }
+  atomic_u64_add( &state->sum, sum );
+  return 0;
+} // -------------------------------------------------------------------------
+
+static void bench( u32 pairs )
+{
+  bench_state state;
+  state.queue = mpmc_queue_create( u64, QUEUE_CAPACITY, MEM_TAG_PROCESS );
+  state.per_producer = ELEMENTS_TOTAL / pairs;
+  state.total = state.per_producer * pairs;
+  state.popped = 0;
+  state.sum = 0;
+  state.ready = 0;
+  state.start = 0;
+
+  SDL_Thread* threads[ 32 ];
+  for( u32 i = 0; i < pairs; i++ )
+  {
+    threads[ i * 2 ] = SDL_CreateThread( producer, "mpmc producer", &state );
+    threads[ i * 2 + 1 ] = SDL_CreateThread( consumer, "mpmc consumer", &state );
+  }
+
+  // start every thread at once so thread creation stays out of the timing
+  while( atomic_u64_load( &state.ready ) < pairs * 2 ) SDL_Delay( 0 );
+  f64 start = now_seconds();
+  atomic_u32_store( &state.start, 1 );
+
+  for( u32 i = 0; i < pairs * 2; i++ )
+    SDL_WaitThread( threads[ i ], 0 );
+  f64 seconds = now_seconds() - start;
+
+  u64 expected = pairs * ( state.per_producer * ( state.per_producer + 1 ) / 2 );
+  printf( "%2u pairs  %8.2f M elements/s  %6.1f ns/element%s\n",
+          pairs, (f64)state.total / seconds / 1e6, seconds * 1e9 / (f64)state.total,
+          state.sum == expected ? "" : "  ELEMENTS LOST OR DUPLICATED" );
+
+  mpmc_queue_destroy( state.queue );
+} // -------------------------------------------------------------------------
+
+int main( int argc, char** argv )
+{
+  (void)argc;
+  (void)argv;
+
+  memory_initialize();
+  printf( "mpmc queue, %u elements through %u slots\n", ELEMENTS_TOTAL, QUEUE_CAPACITY );
+  for( u32 pairs = 1; pairs <= 16; pairs *= 2 )
+    bench( pairs );
+  memory_shutdown();
+  return 0;
+} // -------------------------------------------------------------------------